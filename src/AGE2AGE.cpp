@@ -40,6 +40,12 @@ using namespace Rcpp;
  * 2005 oct 20 - Added Huang's Pj.
  * 2009 aug 28 - Added Nigh's 2009 Ep.
  * 2010 mar 4  - Added Nigh's 2009 Ba.
+ * 2026 oct 18 - Replaced the list of "AC" curves with the age rule
+ *               from the curve registry.
+ *             - The body is now si_age_to_age() in sindex.h, testing the
+ *               registry's bitset of "AC" curves, so the solvers can
+ *               convert ages without resolving the curve.
+ *             - Added si_age_to_age_batch() and Sindex_AgeToAgeBatch().
  */
 
 // [[Rcpp::export]]
@@ -50,181 +56,46 @@ double age_to_age (
     short int age2_type,
     double y2bh)
 {
-  double rvalue;
+  return si_age_to_age (cu_index, age1, age1_type, age2_type, y2bh);
+}
 
 
-  switch (cu_index)
-  {
-#ifdef SI_ACB_HUANGAC
-  case SI_ACB_HUANGAC:
-#endif
-#ifdef SI_ACT_THROWERAC
-  case SI_ACT_THROWERAC:
-#endif
-#ifdef SI_AT_NIGH
-  case SI_AT_NIGH:
-#endif
-#ifdef SI_BA_KURUCZ82AC
-  case SI_BA_KURUCZ82AC:
-#endif
-#ifdef SI_BA_NIGH
-  case SI_BA_NIGH:
-#endif
-#ifdef SI_BL_CHENAC
-  case SI_BL_CHENAC:
-#endif
-#ifdef SI_BP_CURTISAC
-  case SI_BP_CURTISAC:
-#endif
-#ifdef SI_CWC_KURUCZAC
-  case SI_CWC_KURUCZAC:
-#endif
-#ifdef SI_CWI_NIGH
-  case SI_CWI_NIGH:
-#endif
-#ifdef SI_DR_NIGH
-  case SI_DR_NIGH:
-#endif
-#ifdef SI_EP_NIGH
-  case SI_EP_NIGH:
-#endif
-#ifdef SI_FDC_BRUCENIGH
-  case SI_FDC_BRUCENIGH:
-#endif
-#ifdef SI_FDC_BRUCEAC
-  case SI_FDC_BRUCEAC:
-#endif
-#ifdef SI_FDC_NIGHTA
-  case SI_FDC_NIGHTA:
-#endif
-#ifdef SI_FDI_THROWERAC
-  case SI_FDI_THROWERAC:
-#endif
-#ifdef SI_HM_MEANSAC
-  case SI_HM_MEANSAC:
-#endif
-#ifdef SI_HWC_WILEYAC
-  case SI_HWC_WILEYAC:
-#endif
-#ifdef SI_HWI_NIGH
-  case SI_HWI_NIGH:
-#endif
-#ifdef SI_LW_NIGH
-  case SI_LW_NIGH:
-#endif
-#ifdef SI_PJ_HUANG
-  case SI_PJ_HUANG:
-#endif
-#ifdef SI_PJ_HUANGAC
-  case SI_PJ_HUANGAC:
-#endif
-#ifdef SI_PLI_NIGHTA2004
-  case SI_PLI_NIGHTA2004:
-#endif
-#ifdef SI_PLI_NIGHTA98
-  case SI_PLI_NIGHTA98:
-#endif
-#ifdef SI_PLI_THROWNIGH
-  case SI_PLI_THROWNIGH:
-#endif
-#ifdef SI_PLI_THROWER
-  case SI_PLI_THROWER:
-#endif
-#ifdef SI_PW_CURTISAC
-  case SI_PW_CURTISAC:
-#endif
-#ifdef SI_PY_HANNAC
-  case SI_PY_HANNAC:
-#endif
-#ifdef SI_PY_NIGH
-  case SI_PY_NIGH:
-#endif
-#ifdef SI_SB_NIGH
-  case SI_SB_NIGH:
-#endif
-#ifdef SI_SE_CHENAC
-  case SI_SE_CHENAC:
-#endif
-#ifdef SI_SE_NIGHTA
-  case SI_SE_NIGHTA:
-#endif
-#ifdef SI_SW_GOUDIE_NATAC
-  case SI_SW_GOUDIE_NATAC:
-#endif
-#ifdef SI_SW_GOUDIE_PLAAC
-  case SI_SW_GOUDIE_PLAAC:
-#endif
-#ifdef SI_SW_GOUDNIGH
-  case SI_SW_GOUDNIGH:
-#endif
-#ifdef SI_SW_NIGHTA2004
-  case SI_SW_NIGHTA2004:
-#endif
-#ifdef SI_SW_NIGHTA
-  case SI_SW_NIGHTA:
-#endif
-#ifdef SI_SS_NIGH
-  case SI_SS_NIGH:
-#endif
-    if (age1_type == SI_AT_BREAST)
-  {
-    if (age2_type == SI_AT_TOTAL)
-    {
-      /* convert to total age */
-      rvalue = age1 + y2bh - 0.5;
-      if (rvalue < 0)
-        rvalue = 0;
-      return rvalue;
-    }
+void si_age_to_age_batch (
+  int n,
+  const int *cu_index,
+  const double *age1,
+  const int *age1_type,
+  const int *age2_type,
+  const double *y2bh,
+  double *age2)
+{
+  int i;
 
-    return SI_ERR_AGE_TYPE;
-  }
 
-    if (age1_type == SI_AT_TOTAL)
-    {
-      if (age2_type == SI_AT_BREAST)
-      {
-        /* convert to breast-height age */
-        rvalue = age1 - y2bh + 0.5;
-        if (rvalue < 0)
-          rvalue = 0;
-        return rvalue;
-      }
+  for (i = 0; i < n; i++)
+    age2[i] = si_age_to_age ((short int) cu_index[i], age1[i],
+      (short int) age1_type[i], (short int) age2_type[i], y2bh[i]);
+}
 
-      return SI_ERR_AGE_TYPE;
-    }
-    break;
 
-  default:
-    if (age1_type == SI_AT_BREAST)
-    {
-      if (age2_type == SI_AT_TOTAL)
-      {
-        /* convert to total age */
-        rvalue = age1 + y2bh;
-        if (rvalue < 0)
-          rvalue = 0;
-        return rvalue;
-      }
+// [[Rcpp::export]]
+NumericVector Sindex_AgeToAgeBatch (
+    IntegerVector cu_index,
+    NumericVector age1,
+    IntegerVector age1_type,
+    IntegerVector age2_type,
+    NumericVector y2bh)
+{
+  int n = cu_index.size ();
 
-      return SI_ERR_AGE_TYPE;
-    }
 
-    if (age1_type == SI_AT_TOTAL)
-    {
-      if (age2_type == SI_AT_BREAST)
-      {
-        /* convert to breast-height age */
-        rvalue = age1 - y2bh;
-        if (rvalue < 0)
-          rvalue = 0;
-        return rvalue;
-      }
+  if (age1.size () != n || age1_type.size () != n ||
+      age2_type.size () != n || y2bh.size () != n)
+    stop ("all inputs must have the same length");
 
-      return SI_ERR_AGE_TYPE;
-    }
-    break;
-  }
+  NumericVector age2 (n);
+  si_age_to_age_batch (n, cu_index.begin (), age1.begin (),
+    age1_type.begin (), age2_type.begin (), y2bh.begin (), age2.begin ());
 
-  return SI_ERR_AGE_TYPE;
+  return age2;
 }
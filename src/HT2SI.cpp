@@ -132,6 +132,23 @@ using namespace Rcpp;
                                *      apr 14 - Added 2010 Sw Hu and Garcia.
                                * 2014 sep 2  - Added 2014 Se Nigh GI.
                                * 2016 mar 9  - Added parameter to index_to_height().
+                               * 2026 oct 18 - Counted solver steps in si_solver_steps.
+                               *             - Counted solves for telemetry.
+                               *             - Traced calls of height_to_index() and the
+                               *               solvers.  The body of height_to_index() is
+                               *               now si_height_to_index().
+                               *             - Added SI_EST_APPROX, using the fitted equations of
+                               *               siapprox.c at breast height age.
+                               *             - SI_EST_APPROX at total age solves by
+                               *               total_iterate(), a regula falsi on height at
+                               *               total age computed in one pass.
+                               *             - site_iterate() converts ages by si_age_to_age().
+                               *             - total_iterate() returns NaN for a NaN or infinite
+                               *               age or height.
+                               *             - total_iterate() brackets upward from where the
+                               *               curve gives a height, rather than returning 1.3
+                               *               for a NaN there, and takes Newton steps on curves
+                               *               with gradient kernels.
                                */
 
 
@@ -142,7 +159,9 @@ using namespace Rcpp;
 #define LLOG(x) \
 (((x) <= 0.0) ? log (.00001) : log (x))
 
+static double si_height_to_index (short int, double, short int, double, short int);
 static double site_iterate (short int, double, short int, double);
+static double total_iterate (short int, double, double);
 static double ba_height_to_index (short int, double, double, short int);
 static double hu_garcia_q (double, double);
 static double hu_garcia_h (double, double);
@@ -155,6 +174,25 @@ double height_to_index (
     short int age_type,
     double height,
     short int si_est_type)
+{
+  SI_TRACE_MARK mark;
+  double index;
+
+
+  SI_TRACE_BEGIN (mark);
+  index = si_height_to_index (cu_index, age, age_type, height, si_est_type);
+  SI_TRACE_END (mark, SI_TRACE_INDEX, cu_index, age_type, si_est_type,
+    age, height, NAN, NAN, index);
+  return index;
+}
+
+
+static double si_height_to_index (
+    short int cu_index,
+    double age,
+    short int age_type,
+    double height,
+    short int si_est_type)
 {
   double index;
   double x1, x2;
@@ -179,7 +217,7 @@ double height_to_index (
     index = ba_height_to_index (cu_index, age, height, si_est_type);
   else
   {
-    if (si_est_type == SI_EST_DIRECT)
+    if (si_est_type == SI_EST_DIRECT || si_est_type == SI_EST_APPROX)
     {
       switch (cu_index)
       {
@@ -202,6 +240,9 @@ double height_to_index (
 #endif
 
       default:
+        if (si_est_type == SI_EST_APPROX)
+          index = total_iterate (cu_index, age, height);
+        else
           index = site_iterate (cu_index, age, SI_AT_TOTAL, height);
         break;
       }
@@ -229,6 +270,15 @@ double ba_height_to_index (
     index = SI_ERR_GI_MIN; /* indicator that it can't be done */
           else
           {
+            if (si_est_type == SI_EST_APPROX)
+            {
+              /* fitted equation where accepted, else as direct */
+              index = si_approx_index (cu_index, bhage, height);
+              if (index != SI_ERR_NO_ANS)
+                return index;
+              si_est_type = SI_EST_DIRECT;
+            }
+
             if (si_est_type == SI_EST_DIRECT)
             {
               switch (cu_index)
@@ -1792,17 +1842,26 @@ static double site_iterate (
   double step;
   double test_top;
   double y2bh;
+  short int end;
+  int n;
+  SI_TRACE_MARK mark;
 
 
+  SI_TRACE_BEGIN (mark);
+
   /* initial guess */
   site = height;
   if (site < 1.3)
     site = 1.3;
   step = site/2.0;
+  n = 0;
 
   /* loop until real close, or other end condition */
   do
   {
+    si_solver_steps++;
+    n++;
+
     /* estimate y2bh */
     y2bh = si_y2bh (cu_index, site);
 
@@ -1814,17 +1873,19 @@ static double site_iterate (
       {
         /* cannot do this for GI equations */
         site = SI_ERR_GI_TOT;
+        end = SI_END_ERROR;
         break;
       }
       /* was age - y2bh */
       test_top = index_to_height (cu_index,
-                                  age_to_age (cu_index, age, SI_AT_TOTAL, SI_AT_BREAST, y2bh),
+                                  si_age_to_age (cu_index, age, SI_AT_TOTAL, SI_AT_BREAST, y2bh),
                                   SI_AT_BREAST, site, y2bh, 0.5); // 0.5 may have to change
     }
 
     if (test_top == SI_ERR_CURVE) /* unknown cu_index */
     {
       site = test_top;
+      end = SI_END_ERROR;
       break;
     }
     else if (test_top == SI_ERR_NO_ANS) /* height > 999 */
@@ -1832,11 +1893,13 @@ static double site_iterate (
       else if (test_top == SI_ERR_GI_MAX) /* bhage > range for GI model */
       {
         site = test_top;
+        end = SI_END_ERROR;
         break;
       }
       else if (test_top == SI_ERR_GI_MIN) /* bhage < 0.5 for GI model */
       {
         site = test_top;
+        end = SI_END_ERROR;
         break;
       }
 
@@ -1862,18 +1925,23 @@ static double site_iterate (
         site += step;
       }
       else
+      {
         /* done */
+        end = SI_END_CONVERGED;
         break;
+      }
 
       /* check for lack of convergence, so we're not here forever */
       if (step < 0.00001 && step > -0.00001)
       {
         /* we have a value, but perhaps not too accurate */
+        end = SI_END_STEP;
         break;
       }
       if (site > 999.0)
       {
         site = SI_ERR_NO_ANS;
+        end = SI_END_LIMIT;
         break;
       }
       /* site index must be at least 1.3 */
@@ -1887,6 +1955,315 @@ static double site_iterate (
       }
   } while (1);
 
+  if (SI_TELEMETRY_ON)
+    si_telemetry_solve (SI_SOLVE_SITE, cu_index, end, site, n);
+  SI_TRACE_END (mark, SI_TRACE_SOLVE + SI_SOLVE_SITE, cu_index, age_type, -1,
+    age, height, NAN, NAN, site);
+  return site;
+}
+
+
+/*
+ * height at total age for a site index, as site_iterate() finds it:
+ * years to breast height from the site index, breast height age from
+ * those, and height from the curve's height_n(), for the one row.
+ * Returns an error code from either.  For a curve with kernels, the
+ * height comes from its gradient kernel instead, and slope is its
+ * derivative by site index, through y2bh as well; otherwise NaN.
+ */
+static double total_height (
+    const SI_CURVE *cu,
+    short int cu_index,
+    double age,
+    double corr,
+    double site,
+    double *slope)
+{
+  double y2bh;
+  double bhage;
+  double ht;
+  double d_site;
+  double d_age;
+  int age_type;
+
+
+  si_solver_steps++;
+  *slope = NAN;
+  y2bh = cu->y2bh (cu_index, site);
+  if (y2bh == SI_ERR_GI_TOT || y2bh == SI_ERR_CURVE || y2bh == SI_ERR_LT13)
+    return y2bh;
+
+  /* as age_to_age() */
+  bhage = age - y2bh + corr;
+  if (bhage < 0)
+    bhage = 0;
+
+  age_type = SI_AT_BREAST;
+  if (!cu->kernel)
+  {
+    cu->height_n (cu_index, 1, &bhage, &age_type, &site, &y2bh, 0.5, &ht);
+    return ht;
+  }
+
+  cu->height_grad (cu_index, 1, &bhage, &age_type, &site, &y2bh, 0.5, &ht,
+    &d_site, &d_age);
+  if (ht < 0 && ht == (int) ht)
+    return ht;
+  *slope = d_site;
+  if (bhage > 0)
+    *slope -= d_age * si_y2bh_grad (cu_index, site);
+  return ht;
+}
+
+
+/*
+ * site index from height and total age by the regula falsi, with the
+ * Illinois change: the end of the bracket that stays put has its value
+ * halved.  Starts from site_iterate()'s guess, brackets the root by
+ * doubling up or going to 1.3 down, and stops within 0.001 m of height.
+ * Where the curve has a slope, Newton steps are taken instead while
+ * they stay inside those moves and keep halving the miss.
+ *
+ * A site where the curve gives NaN, or SI_ERR_NO_ANS after it has given
+ * a height, is taken as past the root on the side the search came from:
+ * going down from a site that is too high, it is a lower bound, and the
+ * bracket is closed upward from there to where the curve is defined.
+ * Doubling tries sites site_iterate() never reaches, so SI_ERR_NO_ANS
+ * there is returned only if the root is at its edge.  Other error codes
+ * from the curve are returned, as site_iterate() ends up doing.
+ */
+static double total_solve (
+    const SI_CURVE *cu,
+    short int cu_index,
+    double age,
+    double height,
+    short int *end,
+    int *n)
+{
+  double corr;
+  double lo, hi;
+  double f_lo, f_hi;
+  double site;
+  double f;
+  double f_last;
+  double slope;
+  double next;
+  double width;
+  short int side;
+  short int valid;      /* the curve has given a height */
+  short int bad;        /* no height here: 1 NaN, 2 SI_ERR_NO_ANS */
+  short int lo_bad;     /* bad at lo */
+  short int hi_bad;     /* bad at hi */
+  short int low;        /* site is below the root */
+
+
+  corr = (cu->age_rule == SI_AGE_AC) ? 0.5 : 0.0;
+
+  site = height;
+  if (site < 1.3)
+    site = 1.3;
+  lo = hi = site;
+  f_lo = f_hi = 0;
+  valid = lo_bad = hi_bad = 0;
+
+  /* bracket */
+  do
+  {
+    (*n)++;
+    f = total_height (cu, cu_index, age, corr, site, &slope);
+    bad = 0;
+    if (f == SI_ERR_NO_ANS && valid)
+      bad = 2;
+    else if (f < 0 && f == (int) f)
+    {
+      *end = SI_END_ERROR;
+      return f;
+    }
+    else if (f != f)
+      bad = 1;
+
+    if (bad)
+    {
+      /* below the root unless going up from a site below it */
+      f = NAN;
+      low = !(f_lo < 0);
+    }
+    else
+    {
+      valid = 1;
+      f -= height;
+      if (f <= 0.001 && f >= -0.001)
+      {
+        *end = SI_END_CONVERGED;
+        return site;
+      }
+      low = (f < 0);
+    }
+
+    if (low)
+    {
+      lo = site;
+      f_lo = bad ? -0.001 : f;
+      lo_bad = bad;
+      if (f_hi > 0)
+        break;
+      if (site >= 999.0)
+      {
+        *end = SI_END_LIMIT;
+        return SI_ERR_NO_ANS;
+      }
+      next = (site * 2 < 999.0) ? site * 2 : 999.0;
+      if (site - f / slope > site && site - f / slope < next)
+        next = site - f / slope;
+    }
+    else
+    {
+      hi = site;
+      f_hi = bad ? 0.001 : f;
+      hi_bad = bad;
+      if (f_lo < 0)
+        break;
+      if (site <= 1.3)
+      {
+        /* site index must be at least 1.3 */
+        *end = SI_END_STEP;
+        return 1.3;
+      }
+      next = 1.3;
+      if (site - f / slope > 1.3 && site - f / slope < site)
+        next = site - f / slope;
+    }
+    site = next;
+  } while (1);
+
+  /* narrow */
+  side = 0;
+  width = 2 * (hi - lo);
+  f_last = 2 * f;
+  do
+  {
+    if (hi - lo < 0.00001)
+    {
+      if (lo_bad == 2 || hi_bad == 2)
+      {
+        *end = SI_END_LIMIT;
+        return SI_ERR_NO_ANS;
+      }
+      *end = SI_END_STEP;
+      return (lo + hi) / 2.0;
+    }
+
+    /*
+     * a Newton step from the last site if it falls inside and the miss
+     * halved; else bisect if the last step did not halve the bracket, as
+     * at a jump in the curve, or if the secant falls outside, as for a
+     * curve giving NaN
+     */
+    next = site - f / slope;
+    if (next > lo && next < hi && fabs (f) <= fabs (f_last) / 2)
+      site = next;
+    else
+    {
+      site = (lo * f_hi - hi * f_lo) / (f_hi - f_lo);
+      if (hi - lo > width / 2 || !(site > lo && site < hi))
+        site = (lo + hi) / 2.0;
+    }
+    width = hi - lo;
+    f_last = f;
+    (*n)++;
+    f = total_height (cu, cu_index, age, corr, site, &slope);
+    bad = 0;
+    if (f == SI_ERR_NO_ANS)
+      bad = 2;
+    else if (f < 0 && f == (int) f)
+    {
+      *end = SI_END_ERROR;
+      return f;
+    }
+    else if (f != f)
+      bad = 1;
+
+    if (bad)
+    {
+      /* on the side of the end with no height */
+      f = NAN;
+      low = lo_bad || !hi_bad;
+    }
+    else
+    {
+      f -= height;
+      if (f <= 0.001 && f >= -0.001)
+      {
+        *end = SI_END_CONVERGED;
+        return site;
+      }
+      low = (f < 0);
+    }
+
+    if (low)
+    {
+      lo = site;
+      f_lo = bad ? -0.001 : f;
+      lo_bad = bad;
+      if (side < 0)
+        f_hi /= 2.0;
+      side = -1;
+    }
+    else
+    {
+      hi = site;
+      f_hi = bad ? 0.001 : f;
+      hi_bad = bad;
+      if (side > 0)
+        f_lo /= 2.0;
+      side = 1;
+    }
+  } while (1);
+}
+
+
+/*
+ * site index from height and total age for SI_EST_APPROX, by
+ * total_solve().  Needs fewer evaluations of the curve than
+ * site_iterate(), but answers differ from site_iterate()'s within its
+ * 0.01 m tolerance.  Where no site index gives the height, near a
+ * curve's limits, one may return SI_ERR_NO_ANS and the other the site
+ * index it stopped at.  A NaN or infinite age or height gives NaN.
+ */
+static double total_iterate (
+    short int cu_index,
+    double age,
+    double height)
+{
+  const SI_CURVE *cu;
+  double site;
+  short int end;
+  int n;
+  SI_TRACE_MARK mark;
+
+
+  SI_TRACE_BEGIN (mark);
+
+  n = 0;
+  cu = si_curve (cu_index);
+  if (cu == NULL)
+  {
+    site = SI_ERR_CURVE;
+    end = SI_END_ERROR;
+  }
+  else if (!isfinite (age) || !isfinite (height))
+  {
+    /* every comparison in the search would be false */
+    site = NAN;
+    end = SI_END_ERROR;
+  }
+  else
+    site = total_solve (cu, cu_index, age, height, &end, &n);
+
+  if (SI_TELEMETRY_ON)
+    si_telemetry_solve (SI_SOLVE_TOTAL, cu_index, end, site, n);
+  SI_TRACE_END (mark, SI_TRACE_SOLVE + SI_SOLVE_TOTAL, cu_index, SI_AT_TOTAL,
+    -1, age, height, NAN, NAN, site);
   return site;
 }
 
@@ -1894,15 +2271,22 @@ static double site_iterate (
 static double hu_garcia_q (double site_index, double bhage)
 {
   double h, q, step, diff, lastdiff;
+  short int end;
+  int n;
+  SI_TRACE_MARK mark;
 
 
+  SI_TRACE_BEGIN (mark);
   q = 0.02;
   step = 0.01;
   lastdiff = 0;
   diff = 0;
+  n = 0;
 
   do
   {
+    si_solver_steps++;
+    n++;
     h = hu_garcia_h (q, bhage);
     lastdiff = diff;
     diff = site_index - h;
@@ -1921,11 +2305,21 @@ static double hu_garcia_q (double site_index, double bhage)
         q = 0.0000001;
     }
     else
+    {
+      end = SI_END_CONVERGED;
       break;
+    }
     if (step < 0.0000001)
+    {
+      end = SI_END_STEP;
       break;
+    }
   } while (1);
 
+  if (SI_TELEMETRY_ON)
+    si_telemetry_solve (SI_SOLVE_HU_GARCIA, SI_SW_HU_GARCIA, end, q, n);
+  SI_TRACE_END (mark, SI_TRACE_SOLVE + SI_SOLVE_HU_GARCIA, SI_SW_HU_GARCIA,
+    SI_AT_BREAST, -1, bhage, NAN, site_index, NAN, q);
   return q;
 }
 
@@ -20,6 +20,21 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// Sindex_AgeToAgeBatch
+NumericVector Sindex_AgeToAgeBatch(IntegerVector cu_index, NumericVector age1, IntegerVector age1_type, IntegerVector age2_type, NumericVector y2bh);
+RcppExport SEXP _SIndexR_Sindex_AgeToAgeBatch(SEXP cu_indexSEXP, SEXP age1SEXP, SEXP age1_typeSEXP, SEXP age2_typeSEXP, SEXP y2bhSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age1(age1SEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age1_type(age1_typeSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age2_type(age2_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type y2bh(y2bhSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_AgeToAgeBatch(cu_index, age1, age1_type, age2_type, y2bh));
+    return rcpp_result_gen;
+END_RCPP
+}
 // fiz_check
 short int fiz_check(char fiz);
 RcppExport SEXP _SIndexR_fiz_check(SEXP fizSEXP) {
@@ -59,6 +74,19 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// Sindex_SCToSIBatch
+NumericVector Sindex_SCToSIBatch(IntegerVector sp_index, SEXP sitecl, SEXP fiz);
+RcppExport SEXP _SIndexR_Sindex_SCToSIBatch(SEXP sp_indexSEXP, SEXP siteclSEXP, SEXP fizSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type sp_index(sp_indexSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type sitecl(siteclSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type fiz(fizSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_SCToSIBatch(sp_index, sitecl, fiz));
+    return rcpp_result_gen;
+END_RCPP
+}
 // index_to_age
 double index_to_age(short int cu_index, double site_height, short int age_type, double site_index, double y2bh);
 RcppExport SEXP _SIndexR_index_to_age(SEXP cu_indexSEXP, SEXP site_heightSEXP, SEXP age_typeSEXP, SEXP site_indexSEXP, SEXP y2bhSEXP) {
@@ -90,6 +118,241 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// Sindex_ApproxReport
+DataFrame Sindex_ApproxReport();
+RcppExport SEXP _SIndexR_Sindex_ApproxReport() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(Sindex_ApproxReport());
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_AgeSIToHtBatch
+NumericVector Sindex_AgeSIToHtBatch(IntegerVector cu_index, NumericVector age, IntegerVector age_type, NumericVector site_index, NumericVector y2bh, double pi, int tier);
+RcppExport SEXP _SIndexR_Sindex_AgeSIToHtBatch(SEXP cu_indexSEXP, SEXP ageSEXP, SEXP age_typeSEXP, SEXP site_indexSEXP, SEXP y2bhSEXP, SEXP piSEXP, SEXP tierSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type site_index(site_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type y2bh(y2bhSEXP);
+    Rcpp::traits::input_parameter< double >::type pi(piSEXP);
+    Rcpp::traits::input_parameter< int >::type tier(tierSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_AgeSIToHtBatch(cu_index, age, age_type, site_index, y2bh, pi, tier));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_HtAgeToSIBatch
+NumericVector Sindex_HtAgeToSIBatch(IntegerVector cu_index, NumericVector age, IntegerVector age_type, NumericVector height, IntegerVector est_type, int tier);
+RcppExport SEXP _SIndexR_Sindex_HtAgeToSIBatch(SEXP cu_indexSEXP, SEXP ageSEXP, SEXP age_typeSEXP, SEXP heightSEXP, SEXP est_typeSEXP, SEXP tierSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type height(heightSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type est_type(est_typeSEXP);
+    Rcpp::traits::input_parameter< int >::type tier(tierSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_HtAgeToSIBatch(cu_index, age, age_type, height, est_type, tier));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_HtSIToAgeBatch
+NumericVector Sindex_HtSIToAgeBatch(IntegerVector cu_index, NumericVector height, IntegerVector age_type, NumericVector site_index, NumericVector y2bh);
+RcppExport SEXP _SIndexR_Sindex_HtSIToAgeBatch(SEXP cu_indexSEXP, SEXP heightSEXP, SEXP age_typeSEXP, SEXP site_indexSEXP, SEXP y2bhSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type height(heightSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type site_index(site_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type y2bh(y2bhSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_HtSIToAgeBatch(cu_index, height, age_type, site_index, y2bh));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_AgeSIToHtCoded
+DataFrame Sindex_AgeSIToHtCoded(IntegerVector cu_index, NumericVector age, IntegerVector age_type, NumericVector site_index, NumericVector y2bh, double pi, int tier);
+RcppExport SEXP _SIndexR_Sindex_AgeSIToHtCoded(SEXP cu_indexSEXP, SEXP ageSEXP, SEXP age_typeSEXP, SEXP site_indexSEXP, SEXP y2bhSEXP, SEXP piSEXP, SEXP tierSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type site_index(site_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type y2bh(y2bhSEXP);
+    Rcpp::traits::input_parameter< double >::type pi(piSEXP);
+    Rcpp::traits::input_parameter< int >::type tier(tierSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_AgeSIToHtCoded(cu_index, age, age_type, site_index, y2bh, pi, tier));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_HtAgeToSICoded
+DataFrame Sindex_HtAgeToSICoded(IntegerVector cu_index, NumericVector age, IntegerVector age_type, NumericVector height, IntegerVector est_type, int tier);
+RcppExport SEXP _SIndexR_Sindex_HtAgeToSICoded(SEXP cu_indexSEXP, SEXP ageSEXP, SEXP age_typeSEXP, SEXP heightSEXP, SEXP est_typeSEXP, SEXP tierSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type height(heightSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type est_type(est_typeSEXP);
+    Rcpp::traits::input_parameter< int >::type tier(tierSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_HtAgeToSICoded(cu_index, age, age_type, height, est_type, tier));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_Benchmark
+DataFrame Sindex_Benchmark(int reps);
+RcppExport SEXP _SIndexR_Sindex_Benchmark(SEXP repsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type reps(repsSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_Benchmark(reps));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_SIFit
+List Sindex_SIFit(IntegerVector plot, IntegerVector cu_index, NumericVector age, IntegerVector age_type, NumericVector height, int tier);
+RcppExport SEXP _SIndexR_Sindex_SIFit(SEXP plotSEXP, SEXP cu_indexSEXP, SEXP ageSEXP, SEXP age_typeSEXP, SEXP heightSEXP, SEXP tierSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type plot(plotSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type height(heightSEXP);
+    Rcpp::traits::input_parameter< int >::type tier(tierSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_SIFit(plot, cu_index, age, age_type, height, tier));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_AgeSIToHtGrad
+DataFrame Sindex_AgeSIToHtGrad(IntegerVector cu_index, NumericVector age, IntegerVector age_type, NumericVector site_index, NumericVector y2bh, double pi);
+RcppExport SEXP _SIndexR_Sindex_AgeSIToHtGrad(SEXP cu_indexSEXP, SEXP ageSEXP, SEXP age_typeSEXP, SEXP site_indexSEXP, SEXP y2bhSEXP, SEXP piSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type site_index(site_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type y2bh(y2bhSEXP);
+    Rcpp::traits::input_parameter< double >::type pi(piSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_AgeSIToHtGrad(cu_index, age, age_type, site_index, y2bh, pi));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_HtAgeToSIGrad
+DataFrame Sindex_HtAgeToSIGrad(IntegerVector cu_index, NumericVector age, IntegerVector age_type, NumericVector height, IntegerVector est_type, int tier);
+RcppExport SEXP _SIndexR_Sindex_HtAgeToSIGrad(SEXP cu_indexSEXP, SEXP ageSEXP, SEXP age_typeSEXP, SEXP heightSEXP, SEXP est_typeSEXP, SEXP tierSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type height(heightSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type est_type(est_typeSEXP);
+    Rcpp::traits::input_parameter< int >::type tier(tierSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_HtAgeToSIGrad(cu_index, age, age_type, height, est_type, tier));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_HeightIncrement
+DataFrame Sindex_HeightIncrement(IntegerVector cu_index, NumericVector age, IntegerVector age_type, NumericVector site_index, NumericVector y2bh, double pi, double step, int tier, bool rate);
+RcppExport SEXP _SIndexR_Sindex_HeightIncrement(SEXP cu_indexSEXP, SEXP ageSEXP, SEXP age_typeSEXP, SEXP site_indexSEXP, SEXP y2bhSEXP, SEXP piSEXP, SEXP stepSEXP, SEXP tierSEXP, SEXP rateSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type site_index(site_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type y2bh(y2bhSEXP);
+    Rcpp::traits::input_parameter< double >::type pi(piSEXP);
+    Rcpp::traits::input_parameter< double >::type step(stepSEXP);
+    Rcpp::traits::input_parameter< int >::type tier(tierSEXP);
+    Rcpp::traits::input_parameter< bool >::type rate(rateSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_HeightIncrement(cu_index, age, age_type, site_index, y2bh, pi, step, tier, rate));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_HeightProject
+List Sindex_HeightProject(IntegerVector cu_index, NumericVector age, int age_type, NumericVector site_index, NumericVector y2bh, double pi, int steps, double step, int tier, int threads);
+RcppExport SEXP _SIndexR_Sindex_HeightProject(SEXP cu_indexSEXP, SEXP ageSEXP, SEXP age_typeSEXP, SEXP site_indexSEXP, SEXP y2bhSEXP, SEXP piSEXP, SEXP stepsSEXP, SEXP stepSEXP, SEXP tierSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< int >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type site_index(site_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type y2bh(y2bhSEXP);
+    Rcpp::traits::input_parameter< double >::type pi(piSEXP);
+    Rcpp::traits::input_parameter< int >::type steps(stepsSEXP);
+    Rcpp::traits::input_parameter< double >::type step(stepSEXP);
+    Rcpp::traits::input_parameter< int >::type tier(tierSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_HeightProject(cu_index, age, age_type, site_index, y2bh, pi, steps, step, tier, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_KernelISA
+std::string Sindex_KernelISA();
+RcppExport SEXP _SIndexR_Sindex_KernelISA() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(Sindex_KernelISA());
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_MathTierReport
+DataFrame Sindex_MathTierReport(int reps);
+RcppExport SEXP _SIndexR_Sindex_MathTierReport(SEXP repsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type reps(repsSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_MathTierReport(reps));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_MonteCarlo
+List Sindex_MonteCarlo(IntegerVector cu_index, NumericVector age, IntegerVector age_type, NumericVector value, NumericVector y2bh, NumericVector sd_value, NumericVector sd_age, bool to_height, int est_type, double pi, int samples, NumericVector prob, double seed, int tier, int threads);
+RcppExport SEXP _SIndexR_Sindex_MonteCarlo(SEXP cu_indexSEXP, SEXP ageSEXP, SEXP age_typeSEXP, SEXP valueSEXP, SEXP y2bhSEXP, SEXP sd_valueSEXP, SEXP sd_ageSEXP, SEXP to_heightSEXP, SEXP est_typeSEXP, SEXP piSEXP, SEXP samplesSEXP, SEXP probSEXP, SEXP seedSEXP, SEXP tierSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type value(valueSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type y2bh(y2bhSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type sd_value(sd_valueSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type sd_age(sd_ageSEXP);
+    Rcpp::traits::input_parameter< bool >::type to_height(to_heightSEXP);
+    Rcpp::traits::input_parameter< int >::type est_type(est_typeSEXP);
+    Rcpp::traits::input_parameter< double >::type pi(piSEXP);
+    Rcpp::traits::input_parameter< int >::type samples(samplesSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type prob(probSEXP);
+    Rcpp::traits::input_parameter< double >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type tier(tierSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_MonteCarlo(cu_index, age, age_type, value, y2bh, sd_value, sd_age, to_height, est_type, pi, samples, prob, seed, tier, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // Sindex_VersionNumber
 short int Sindex_VersionNumber();
 RcppExport SEXP _SIndexR_Sindex_VersionNumber() {
@@ -279,6 +542,93 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// Sindex_Catalog
+List Sindex_Catalog();
+RcppExport SEXP _SIndexR_Sindex_Catalog() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(Sindex_Catalog());
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_StressTest
+int Sindex_StressTest(int rounds, int threads);
+RcppExport SEXP _SIndexR_Sindex_StressTest(SEXP roundsSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type rounds(roundsSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_StressTest(rounds, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_TelemetryOn
+bool Sindex_TelemetryOn(int on);
+RcppExport SEXP _SIndexR_Sindex_TelemetryOn(SEXP onSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type on(onSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_TelemetryOn(on));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_Telemetry
+List Sindex_Telemetry(bool reset);
+RcppExport SEXP _SIndexR_Sindex_Telemetry(SEXP resetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type reset(resetSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_Telemetry(reset));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_TopHeight
+List Sindex_TopHeight(IntegerVector plot, IntegerVector species, IntegerVector cu_index, NumericVector dbh, NumericVector height, NumericVector age, NumericVector stems, int age_type, int est_type, double top, int tier);
+RcppExport SEXP _SIndexR_Sindex_TopHeight(SEXP plotSEXP, SEXP speciesSEXP, SEXP cu_indexSEXP, SEXP dbhSEXP, SEXP heightSEXP, SEXP ageSEXP, SEXP stemsSEXP, SEXP age_typeSEXP, SEXP est_typeSEXP, SEXP topSEXP, SEXP tierSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type plot(plotSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type species(speciesSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type dbh(dbhSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type height(heightSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type stems(stemsSEXP);
+    Rcpp::traits::input_parameter< int >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< int >::type est_type(est_typeSEXP);
+    Rcpp::traits::input_parameter< double >::type top(topSEXP);
+    Rcpp::traits::input_parameter< int >::type tier(tierSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_TopHeight(plot, species, cu_index, dbh, height, age, stems, age_type, est_type, top, tier));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_TraceOn
+int Sindex_TraceOn(int depth);
+RcppExport SEXP _SIndexR_Sindex_TraceOn(SEXP depthSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type depth(depthSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_TraceOn(depth));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_Trace
+DataFrame Sindex_Trace(bool clear);
+RcppExport SEXP _SIndexR_Sindex_Trace(SEXP clearSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type clear(clearSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_Trace(clear));
+    return rcpp_result_gen;
+END_RCPP
+}
 // si_y2bh
 double si_y2bh(short int cu_index, double site_index);
 RcppExport SEXP _SIndexR_si_y2bh(SEXP cu_indexSEXP, SEXP site_indexSEXP) {
@@ -303,6 +653,38 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// Sindex_Y2BHBatch
+NumericVector Sindex_Y2BHBatch(IntegerVector cu_index, NumericVector site_index, bool half);
+RcppExport SEXP _SIndexR_Sindex_Y2BHBatch(SEXP cu_indexSEXP, SEXP site_indexSEXP, SEXP halfSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type site_index(site_indexSEXP);
+    Rcpp::traits::input_parameter< bool >::type half(halfSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_Y2BHBatch(cu_index, site_index, half));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Sindex_YieldTable
+List Sindex_YieldTable(IntegerVector cu_index, NumericVector site_index, NumericVector y2bh, NumericVector age, int age_type, double pi, int tier, int threads, bool long_table);
+RcppExport SEXP _SIndexR_Sindex_YieldTable(SEXP cu_indexSEXP, SEXP site_indexSEXP, SEXP y2bhSEXP, SEXP ageSEXP, SEXP age_typeSEXP, SEXP piSEXP, SEXP tierSEXP, SEXP threadsSEXP, SEXP long_tableSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type cu_index(cu_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type site_index(site_indexSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type y2bh(y2bhSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type age(ageSEXP);
+    Rcpp::traits::input_parameter< int >::type age_type(age_typeSEXP);
+    Rcpp::traits::input_parameter< double >::type pi(piSEXP);
+    Rcpp::traits::input_parameter< int >::type tier(tierSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type long_table(long_tableSEXP);
+    rcpp_result_gen = Rcpp::wrap(Sindex_YieldTable(cu_index, site_index, y2bh, age, age_type, pi, tier, threads, long_table));
+    return rcpp_result_gen;
+END_RCPP
+}
 // species_map
 short int species_map(std::string sc);
 RcppExport SEXP _SIndexR_species_map(SEXP scSEXP) {
@@ -329,11 +711,28 @@ END_RCPP
 
 static const R_CallMethodDef CallEntries[] = {
     {"_SIndexR_age_to_age", (DL_FUNC) &_SIndexR_age_to_age, 5},
+    {"_SIndexR_Sindex_AgeToAgeBatch", (DL_FUNC) &_SIndexR_Sindex_AgeToAgeBatch, 5},
     {"_SIndexR_fiz_check", (DL_FUNC) &_SIndexR_fiz_check, 1},
     {"_SIndexR_height_to_index", (DL_FUNC) &_SIndexR_height_to_index, 5},
     {"_SIndexR_class_to_index", (DL_FUNC) &_SIndexR_class_to_index, 3},
+    {"_SIndexR_Sindex_SCToSIBatch", (DL_FUNC) &_SIndexR_Sindex_SCToSIBatch, 3},
     {"_SIndexR_index_to_age", (DL_FUNC) &_SIndexR_index_to_age, 5},
     {"_SIndexR_index_to_height", (DL_FUNC) &_SIndexR_index_to_height, 6},
+    {"_SIndexR_Sindex_ApproxReport", (DL_FUNC) &_SIndexR_Sindex_ApproxReport, 0},
+    {"_SIndexR_Sindex_AgeSIToHtBatch", (DL_FUNC) &_SIndexR_Sindex_AgeSIToHtBatch, 7},
+    {"_SIndexR_Sindex_HtAgeToSIBatch", (DL_FUNC) &_SIndexR_Sindex_HtAgeToSIBatch, 6},
+    {"_SIndexR_Sindex_HtSIToAgeBatch", (DL_FUNC) &_SIndexR_Sindex_HtSIToAgeBatch, 5},
+    {"_SIndexR_Sindex_AgeSIToHtCoded", (DL_FUNC) &_SIndexR_Sindex_AgeSIToHtCoded, 7},
+    {"_SIndexR_Sindex_HtAgeToSICoded", (DL_FUNC) &_SIndexR_Sindex_HtAgeToSICoded, 6},
+    {"_SIndexR_Sindex_Benchmark", (DL_FUNC) &_SIndexR_Sindex_Benchmark, 1},
+    {"_SIndexR_Sindex_SIFit", (DL_FUNC) &_SIndexR_Sindex_SIFit, 6},
+    {"_SIndexR_Sindex_AgeSIToHtGrad", (DL_FUNC) &_SIndexR_Sindex_AgeSIToHtGrad, 6},
+    {"_SIndexR_Sindex_HtAgeToSIGrad", (DL_FUNC) &_SIndexR_Sindex_HtAgeToSIGrad, 6},
+    {"_SIndexR_Sindex_HeightIncrement", (DL_FUNC) &_SIndexR_Sindex_HeightIncrement, 9},
+    {"_SIndexR_Sindex_HeightProject", (DL_FUNC) &_SIndexR_Sindex_HeightProject, 10},
+    {"_SIndexR_Sindex_KernelISA", (DL_FUNC) &_SIndexR_Sindex_KernelISA, 0},
+    {"_SIndexR_Sindex_MathTierReport", (DL_FUNC) &_SIndexR_Sindex_MathTierReport, 1},
+    {"_SIndexR_Sindex_MonteCarlo", (DL_FUNC) &_SIndexR_Sindex_MonteCarlo, 15},
     {"_SIndexR_Sindex_VersionNumber", (DL_FUNC) &_SIndexR_Sindex_VersionNumber, 0},
     {"_SIndexR_Sindex_FirstSpecies", (DL_FUNC) &_SIndexR_Sindex_FirstSpecies, 0},
     {"_SIndexR_Sindex_NextSpecies", (DL_FUNC) &_SIndexR_Sindex_NextSpecies, 1},
@@ -351,8 +750,17 @@ static const R_CallMethodDef CallEntries[] = {
     {"_SIndexR_Sindex_CurveName", (DL_FUNC) &_SIndexR_Sindex_CurveName, 1},
     {"_SIndexR_Sindex_CurveSource", (DL_FUNC) &_SIndexR_Sindex_CurveSource, 1},
     {"_SIndexR_Sindex_CurveNotes", (DL_FUNC) &_SIndexR_Sindex_CurveNotes, 1},
+    {"_SIndexR_Sindex_Catalog", (DL_FUNC) &_SIndexR_Sindex_Catalog, 0},
+    {"_SIndexR_Sindex_StressTest", (DL_FUNC) &_SIndexR_Sindex_StressTest, 2},
+    {"_SIndexR_Sindex_TelemetryOn", (DL_FUNC) &_SIndexR_Sindex_TelemetryOn, 1},
+    {"_SIndexR_Sindex_Telemetry", (DL_FUNC) &_SIndexR_Sindex_Telemetry, 1},
+    {"_SIndexR_Sindex_TopHeight", (DL_FUNC) &_SIndexR_Sindex_TopHeight, 11},
+    {"_SIndexR_Sindex_TraceOn", (DL_FUNC) &_SIndexR_Sindex_TraceOn, 1},
+    {"_SIndexR_Sindex_Trace", (DL_FUNC) &_SIndexR_Sindex_Trace, 1},
     {"_SIndexR_si_y2bh", (DL_FUNC) &_SIndexR_si_y2bh, 2},
     {"_SIndexR_si_y2bh05", (DL_FUNC) &_SIndexR_si_y2bh05, 2},
+    {"_SIndexR_Sindex_Y2BHBatch", (DL_FUNC) &_SIndexR_Sindex_Y2BHBatch, 3},
+    {"_SIndexR_Sindex_YieldTable", (DL_FUNC) &_SIndexR_Sindex_YieldTable, 9},
     {"_SIndexR_species_map", (DL_FUNC) &_SIndexR_species_map, 1},
     {"_SIndexR_species_remap", (DL_FUNC) &_SIndexR_species_remap, 2},
     {NULL, NULL, 0}
@@ -1,4 +1,6 @@
 #include <Rcpp.h>
+#include <vector>
+#include <mutex>
 #include "sindex.h"
 using namespace Rcpp;
 
@@ -37,6 +39,9 @@ using namespace Rcpp;
  * 1999 jan 8  - Changed int to short int.
  *             - Changed to take species index as parameter.
  * 2000 jul 24 - Split CW into CWI and CWC.
+ * 2026 oct 18 - Added si_class_batch() and Sindex_SCToSIBatch(), looking
+ *               up site index in a table of every species, site class
+ *               and zone, built once from class_to_index().
  */
 
 
@@ -259,3 +264,126 @@ double class_to_index (
 
   return SI_ERR_SPEC;
 }
+
+
+/*
+ * class_to_index() for every species, site class (G, M, P, L) and zone
+ * (unknown, coast, interior), as fiz_check() gives it, with codes for
+ * each character of site class and FIZ.
+ */
+static double si_class_table[SI_MAX_SPECIES][4][3];
+static signed char si_class_code[256];   /* 0 to 3, or -1 */
+static unsigned char si_class_zone[256];  /* FIZ_xxx */
+static std::once_flag si_class_once;
+
+
+static void si_class_build (void)
+{
+  static const char cl[4] = { 'G', 'M', 'P', 'L' };
+  static const char zone[3] = { ' ', 'A', 'D' };   /* one FIZ of each */
+  int sp, c, z, k;
+
+
+  for (k = 0; k < 256; k++)
+  {
+    si_class_code[k] = -1;
+    si_class_zone[k] = (unsigned char) fiz_check ((char) k);
+  }
+  for (c = 0; c < 4; c++)
+    si_class_code[(unsigned char) cl[c]] = (signed char) c;
+
+  for (sp = 0; sp < SI_MAX_SPECIES; sp++)
+    for (c = 0; c < 4; c++)
+      for (z = 0; z < 3; z++)
+        si_class_table[sp][c][z] = class_to_index ((short int) sp, cl[c],
+          zone[z]);
+}
+
+
+/*
+ * class_to_index() for n rows.
+ */
+void si_class_batch (
+  int n,
+  const int *sp_index,
+  const char *sitecl,
+  const char *fiz,
+  double *site)
+{
+  int i, c;
+
+
+  std::call_once (si_class_once, si_class_build);
+
+  for (i = 0; i < n; i++)
+  {
+    c = si_class_code[(unsigned char) sitecl[i]];
+    if (c < 0)
+      site[i] = SI_ERR_CLASS;
+    else if (sp_index[i] < 0 || sp_index[i] >= SI_MAX_SPECIES)
+      site[i] = SI_ERR_SPEC;
+    else
+      site[i] = si_class_table[sp_index[i]][c][si_class_zone[(unsigned char) fiz[i]]];
+  }
+}
+
+
+/*
+ * the first character of each element of a character or factor column,
+ * or 0 for missing.
+ */
+static std::vector<char> si_class_chars (SEXP x, const char *what)
+{
+  std::vector<char> out (Rf_length (x), 0);
+  std::vector<char> level;
+  SEXP levels;
+  int i, k;
+
+
+  if (Rf_isFactor (x))
+  {
+    levels = Rf_getAttrib (x, R_LevelsSymbol);
+    level.resize (Rf_length (levels));
+    for (k = 0; k < (int) level.size (); k++)
+      level[k] = CHAR (STRING_ELT (levels, k))[0];
+    for (i = 0; i < (int) out.size (); i++)
+    {
+      k = INTEGER (x)[i];
+      if (k != NA_INTEGER && k >= 1 && k <= (int) level.size ())
+        out[i] = level[k - 1];
+    }
+  }
+  else if (TYPEOF (x) == STRSXP)
+  {
+    for (i = 0; i < (int) out.size (); i++)
+      if (STRING_ELT (x, i) != NA_STRING)
+        out[i] = CHAR (STRING_ELT (x, i))[0];
+  }
+  else
+    stop (std::string (what) + " must be character or factor");
+
+  return out;
+}
+
+
+// [[Rcpp::export]]
+NumericVector Sindex_SCToSIBatch (
+    IntegerVector sp_index,
+    SEXP sitecl,
+    SEXP fiz)
+{
+  int n = sp_index.size ();
+  std::vector<char> cl, zone;
+
+
+  cl = si_class_chars (sitecl, "sitecl");
+  zone = si_class_chars (fiz, "fiz");
+  if ((int) cl.size () != n || (int) zone.size () != n)
+    stop ("all inputs must have the same length");
+
+  NumericVector site (n);
+  si_class_batch (n, sp_index.begin (), cl.data (), zone.data (),
+    site.begin ());
+
+  return site;
+}
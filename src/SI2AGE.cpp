@@ -1,6 +1,7 @@
 #include <Rcpp.h>
 #include <stdio.h>
 #include <math.h>
+#include <mutex>
 #include "sindex.h"
 using namespace Rcpp;
 
@@ -66,6 +67,16 @@ using namespace Rcpp;
                                     * 2009 may 6  - Forced pure y2bh to be computed for Fdc-Bruce.
                                     *      apr 16 - Added 2010 Sw Hu and Garcia.
                                     * 2016 mar 9  - Added parameter to index_to_height().
+                                    * 2026 oct 18 - TEST output file handle is now per-thread.
+                                    *             - Counted solver steps in si_solver_steps.
+                                    *             - Counted solves for telemetry.
+                                    *             - Traced calls of index_to_age() and the solvers.
+                                    *               The body of index_to_age() is now
+                                    *               si_index_to_age().
+                                    *             - gi_iterate() searches by bisection within each
+                                    *               curve's range of heights over which site index
+                                    *               falls with age, giving the same answers.
+                                    *             - iterate() converts ages by si_age_to_age().
                                     */
 
 
@@ -81,6 +92,7 @@ using namespace Rcpp;
 
 #define MAX_AGE 999.0
 
+static double si_index_to_age (short int, double, short int, double, double);
 static double iterate (short int, double, short int, double, double);
 static double gi_iterate (short int, double, short int, double);
 static double hu_garcia_q (double, double);
@@ -88,7 +100,7 @@ static double hu_garcia_h (double, double);
 static double hu_garcia_bha (double, double);
 
 #ifdef TEST
-FILE *testfile;
+static thread_local FILE *testfile;
 #endif
 
 // [[Rcpp::export]]
@@ -98,6 +110,25 @@ double index_to_age (
     short int age_type,
     double site_index,
     double y2bh)
+{
+  SI_TRACE_MARK mark;
+  double age;
+
+
+  SI_TRACE_BEGIN (mark);
+  age = si_index_to_age (cu_index, site_height, age_type, site_index, y2bh);
+  SI_TRACE_END (mark, SI_TRACE_AGE, cu_index, age_type, -1,
+    NAN, site_height, site_index, y2bh, age);
+  return age;
+}
+
+
+static double si_index_to_age (
+    short int cu_index,
+    double site_height,
+    short int age_type,
+    double site_index,
+    double y2bh)
 {
   double x1, x2, x3, x4;
   double a, b, c;
@@ -505,12 +536,16 @@ static double iterate (
   double step;
   double test_ht;
   short int err_count;
+  short int end;
+  int n;
+  SI_TRACE_MARK mark;
 
 
   /* initial guess */
   si2age = 25;
   step = si2age / 2;
   err_count = 0;
+  n = 0;
 
   /* do a preliminary test to catch some obvious errors */
   test_ht = index_to_height (cu_index, si2age, SI_AT_TOTAL, site_index, y2bh, 0.5); // 0.5 may have to change
@@ -520,11 +555,19 @@ static double iterate (
       test_ht == SI_ERR_GI_MIN ||
       test_ht == SI_ERR_GI_MAX ||
       test_ht == SI_ERR_GI_TOT)
+  {
+    if (SI_TELEMETRY_ON)
+      si_telemetry_solve (SI_SOLVE_AGE, cu_index, SI_END_ERROR, test_ht, 0);
     return test_ht;
+  }
+
+  SI_TRACE_BEGIN (mark);
 
   /* loop until real close, or other end condition */
   do
   {
+    si_solver_steps++;
+    n++;
 #ifdef TEST
     fprintf (testfile, "before index_to_height(age=%f, age_type=%d, site_index=%f, y2bh=%f)\n",
              si2age, age_type, site_index, y2bh);
@@ -543,6 +586,7 @@ static double iterate (
   if (err_count == 100)
   {
     si2age = SI_ERR_NO_ANS;
+    end = SI_END_LIMIT;
     break;
   }
     }
@@ -565,18 +609,23 @@ static double iterate (
       si2age += step;
     }
     else
+    {
       /* done */
+      end = SI_END_CONVERGED;
       break;
+    }
 
     /* check for lack of convergence, so we're not here forever */
     if (step < 0.00001 && step > -0.00001)
     {
       /* we have a value, but perhaps not too accurate */
+      end = SI_END_STEP;
       break;
     }
     if (si2age > 999.0)
     {
       si2age = SI_ERR_NO_ANS;
+      end = SI_END_LIMIT;
 #ifdef TEST
       fprintf (testfile, "Failed due to age too high (> 999).\n");
 #endif
@@ -584,16 +633,199 @@ static double iterate (
     }
   } while (1);
 
+  if (SI_TELEMETRY_ON)
+    si_telemetry_solve (SI_SOLVE_AGE, cu_index, end, si2age, n);
+  SI_TRACE_END (mark, SI_TRACE_SOLVE + SI_SOLVE_AGE, cu_index, SI_AT_TOTAL, -1,
+    NAN, site_height, site_index, y2bh, si2age);
+
   if (si2age >= 0)
     if (age_type == SI_AT_BREAST)
       /* was
       si2age -= y2bh;
       */
-      si2age = age_to_age (cu_index, si2age, SI_AT_TOTAL, SI_AT_BREAST, y2bh);
+      si2age = si_age_to_age (cu_index, si2age, SI_AT_TOTAL, SI_AT_BREAST, y2bh);
     return (si2age);
 }
 
 
+/* a GI curve's site index at an age, as gi_iterate() evaluates it */
+static double gi_site (short int cu_index, int age, double site_height, int *n)
+{
+  si_solver_steps++;
+  (*n)++;
+  return height_to_index (cu_index, age, SI_AT_BREAST, site_height, SI_EST_DIRECT);
+}
+
+/*
+ * gi_iterate() looks for the integer breast height age at which a GI
+ * curve's site index from height is nearest the given one, scanning ages
+ * 1 to 99 until the curve gives SI_ERR_GI_MAX.  For every GI curve, site
+ * index is c + x1 * t^x2, or x1 + x2 * t, with t the height above 1.3 m
+ * over age less a half, and x1, x2 from a table by age.  Whether one age
+ * gives a higher site index than the next then holds for an interval of
+ * log height above 1.3 m, so site index falls with age throughout an
+ * interval of heights.  Within it the nearest age can be found by binary
+ * search, giving the scan's answer exactly.
+ *
+ * The interval is found for each curve on its first use, from the
+ * curve's own equations on SI_GI_GRID heights spaced evenly in log
+ * height above 1.3 m, from 1.3001 to 101.3 m, less a grid step at each
+ * end for rounding.
+ */
+#define SI_GI_GRID 400
+
+typedef struct
+  {
+  int    ages;    /* last age before SI_ERR_GI_MAX, as gi_iterate() scans */
+  double ht_lo;   /* heights over which site index falls with age */
+  double ht_hi;
+  } SI_GI_RANGE;
+
+static SI_GI_RANGE si_gi_range[SI_MAX_CURVES];
+static std::once_flag si_gi_once[SI_MAX_CURVES];
+
+
+static double gi_grid_height (int i)
+{
+  return 1.3 + 0.0001 * pow (10.0, 6.0 * i / (SI_GI_GRID - 1));
+}
+
+
+static void gi_range_build (short int cu_index)
+{
+  SI_GI_RANGE *r;
+  double h, f, prev;
+  int i, a, m, ok;
+  int first, run, best_first, best_run;
+
+
+  r = &si_gi_range[cu_index];
+  r->ages = 0;
+  r->ht_lo = 1;
+  r->ht_hi = 0;
+
+  /* last age, at a middling height */
+  for (a = 1; a < 100; a++)
+    if (height_to_index (cu_index, a, SI_AT_BREAST, 10.0, SI_EST_DIRECT) ==
+        SI_ERR_GI_MAX)
+      break;
+  m = a - 1;
+  if (m < 2)
+    return;
+
+  /* the longest run of heights at which site index falls at every age */
+  first = run = 0;
+  best_first = best_run = 0;
+  for (i = 0; i < SI_GI_GRID; i++)
+  {
+    h = gi_grid_height (i);
+    ok = 1;
+    prev = 0;
+    for (a = 1; a <= m && ok; a++)
+    {
+      f = height_to_index (cu_index, a, SI_AT_BREAST, h, SI_EST_DIRECT);
+      if (!(f >= 0) || (a > 1 && !(f < prev)))
+        ok = 0;
+      prev = f;
+    }
+    if (ok && m < 99 &&
+        height_to_index (cu_index, m + 1, SI_AT_BREAST, h, SI_EST_DIRECT) !=
+        SI_ERR_GI_MAX)
+      ok = 0;
+
+    if (!ok)
+      run = 0;
+    else if (run++ == 0)
+      first = i;
+    if (run > best_run)
+    {
+      best_run = run;
+      best_first = first;
+    }
+  }
+
+  if (best_run < 3)
+    return;
+  r->ages = m;
+  r->ht_lo = gi_grid_height (best_first + 1);
+  r->ht_hi = gi_grid_height (best_first + best_run - 2);
+}
+
+
+static const SI_GI_RANGE *gi_range (short int cu_index)
+{
+  static const SI_GI_RANGE none = { 0, 1, 0 };
+
+
+  if (cu_index < 0 || cu_index >= SI_MAX_CURVES)
+    return &none;
+  std::call_once (si_gi_once[cu_index], gi_range_build, cu_index);
+  return &si_gi_range[cu_index];
+}
+
+
+/*
+ * gi_iterate()'s nearest age, for a height within the curve's range.
+ * Also sets the difference at the last age, which gi_iterate() checks,
+ * and adds the ages evaluated to n.
+ */
+static double gi_search (
+    short int cu_index,
+    double site_height,
+    double site_index,
+    int ages,
+    double *last_diff,
+    int *n)
+{
+  double site[100];
+  int lo, hi, mid, a;
+  double d1, d2;
+
+
+  for (a = 0; a < 100; a++)
+    site[a] = NAN;
+
+  /* first age with site index at or below the given one, ages + 1 if none */
+  lo = 1;
+  hi = ages + 1;
+  while (lo < hi)
+  {
+    mid = (lo + hi) / 2;
+    site[mid] = gi_site (cu_index, mid, site_height, n);
+    if (site[mid] <= site_index)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+
+  if (lo == 1)
+    a = 1;
+  else if (lo > ages)
+    a = ages;
+  else
+  {
+    /* the earlier of two equally near, as the scan */
+    if (site[lo - 1] != site[lo - 1])
+      site[lo - 1] = gi_site (cu_index, lo - 1, site_height, n);
+    if (site[lo] != site[lo])
+      site[lo] = gi_site (cu_index, lo, site_height, n);
+    d1 = site[lo - 1] - site_index;
+    d2 = site_index - site[lo];
+    a = (d2 < d1) ? lo : lo - 1;
+  }
+  if (site[a] != site[a])
+    site[a] = gi_site (cu_index, a, site_height, n);
+  if (!(fabs (site[a] - site_index) < 999))
+    a = 1;
+
+  if (site[ages] != site[ages])
+    site[ages] = gi_site (cu_index, ages, site_height, n);
+  *last_diff = fabs (site[ages] - site_index);
+
+  return a;
+}
+
+
 static double gi_iterate (
     short int cu_index,
     double site_height,
@@ -605,46 +837,72 @@ static double gi_iterate (
   double test_site;
   double diff;
   double mindiff;
+  const SI_GI_RANGE *range;
+  short int end;
+  int n;
+  SI_TRACE_MARK mark;
 
 
   if (age_type == SI_AT_TOTAL)
+  {
+    if (SI_TELEMETRY_ON)
+      si_telemetry_solve (SI_SOLVE_GI_AGE, cu_index, SI_END_ERROR, SI_ERR_GI_TOT, 0);
     return SI_ERR_GI_TOT;
+  }
 
+  SI_TRACE_BEGIN (mark);
   diff = 0;
   mindiff = 999;
   si2age = 1;
-  for (age = 1; age < 100; age += 1)
+  n = 0;
+  range = gi_range (cu_index);
+  if (site_height >= range->ht_lo && site_height <= range->ht_hi &&
+      site_index == site_index)
   {
+    /* same answer, searching */
+    si2age = gi_search (cu_index, site_height, site_index, range->ages,
+      &diff, &n);
+    age = range->ages + 1;
+  }
+  else
+  {
+    for (age = 1; age < 100; age += 1)
+    {
+      si_solver_steps++;
+      n++;
 #ifdef TEST
-    fprintf (testfile, "before height_to_index(age=%f, site_height=%f)\n",
-             age, site_height);
+      fprintf (testfile, "before height_to_index(age=%f, site_height=%f)\n",
+               age, site_height);
 #endif
-    test_site = height_to_index (cu_index, age, SI_AT_BREAST, site_height, SI_EST_DIRECT);
+      test_site = height_to_index (cu_index, age, SI_AT_BREAST, site_height, SI_EST_DIRECT);
 #ifdef TEST
-    fprintf (testfile, "height_to_index()=%f\n", test_site);
+      fprintf (testfile, "height_to_index()=%f\n", test_site);
 #endif
-    if (test_site == SI_ERR_GI_MAX)
-      break;
+      if (test_site == SI_ERR_GI_MAX)
+        break;
 
-    if (test_site > site_index)
-      diff = test_site - site_index;
-    else
-      diff = site_index - test_site;
+      if (test_site > site_index)
+        diff = test_site - site_index;
+      else
+        diff = site_index - test_site;
 
-    if (diff < mindiff)
-    {
-      mindiff = diff;
-      si2age = age;
+      if (diff < mindiff)
+      {
+        mindiff = diff;
+        si2age = age;
+      }
     }
   }
 
+  end = SI_END_CONVERGED;
   if (si2age == 1)
   {
     /* right answer, or not low enough */
     if (diff > 1)
     {
       /* outside tolerance of 1m */
-      return SI_ERR_NO_ANS;
+      si2age = SI_ERR_NO_ANS;
+      end = SI_END_LIMIT;
     }
   }
 
@@ -654,10 +912,15 @@ static double gi_iterate (
     if (diff > 1)
     {
       /* outside tolerance of 1m */
-      return SI_ERR_NO_ANS;
+      si2age = SI_ERR_NO_ANS;
+      end = SI_END_LIMIT;
     }
   }
 
+  if (SI_TELEMETRY_ON)
+    si_telemetry_solve (SI_SOLVE_GI_AGE, cu_index, end, si2age, n);
+  SI_TRACE_END (mark, SI_TRACE_SOLVE + SI_SOLVE_GI_AGE, cu_index, age_type, -1,
+    NAN, site_height, site_index, NAN, si2age);
   return si2age;
 }
 
@@ -665,15 +928,22 @@ static double gi_iterate (
 static double hu_garcia_q (double site_index, double bhage)
 {
   double h, q, step, diff, lastdiff;
+  short int end;
+  int n;
+  SI_TRACE_MARK mark;
 
 
+  SI_TRACE_BEGIN (mark);
   q = 0.02;
   step = 0.01;
   lastdiff = 0;
   diff = 0;
+  n = 0;
 
   do
   {
+    si_solver_steps++;
+    n++;
     h = hu_garcia_h (q, bhage);
     lastdiff = diff;
     diff = site_index - h;
@@ -692,11 +962,21 @@ static double hu_garcia_q (double site_index, double bhage)
         q = 0.0000001;
     }
     else
+    {
+      end = SI_END_CONVERGED;
       break;
+    }
     if (step < 0.0000001)
+    {
+      end = SI_END_STEP;
       break;
+    }
   } while (1);
 
+  if (SI_TELEMETRY_ON)
+    si_telemetry_solve (SI_SOLVE_HU_GARCIA, SI_SW_HU_GARCIA, end, q, n);
+  SI_TRACE_END (mark, SI_TRACE_SOLVE + SI_SOLVE_HU_GARCIA, SI_SW_HU_GARCIA,
+    SI_AT_BREAST, -1, bhage, NAN, site_index, NAN, q);
   return q;
 }
 
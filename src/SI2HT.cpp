@@ -196,6 +196,15 @@ using namespace Rcpp;
  *               to incorporate height smoothing near 1.3m.
  * 2017 feb 2  - Added Nigh's 2016 Cwc equation.
  * 2018 jan 10 - Added Nigh's 2017 Pli equation.
+ * 2026 oct 18 - Removed recursive calls to index_to_height() from the
+ *               high site/low age interpolation of Wiley, Kurucz and
+ *               Harrington curves.  The curve bodies are now in static
+ *               functions called directly.
+ *             - Counted solver steps in si_solver_steps.
+ *             - Counted solves for telemetry.
+ *             - Traced calls of index_to_height() and the solvers.  The
+ *               body of index_to_height() is now si_index_to_height().
+ *             - Ages are converted by si_age_to_age(), inline.
  */
 
 
@@ -205,9 +214,17 @@ using namespace Rcpp;
 #define LLOG(x) \
 (((x) <= 0.0) ? log (.00001) : log (x))
 
+static double si_index_to_height (short int, double, short int, double, double, double);
 static double gi_si2ht (short int, double, double);
 static double hu_garcia_q (double, double);
 static double hu_garcia_h (double, double);
+static double wiley_ht (short int, double, double);
+static double wileyac_ht (double, double, double);
+static double kurucz_cw_ht (double, double);
+static double kurucz_cwac_ht (double, double);
+static double kurucz82_ht (double, double);
+static double kurucz82ac_ht (double, double);
+static double harring_ht (double, double);
 
 
 // [[Rcpp::export]]
@@ -219,6 +236,26 @@ double index_to_height (
     double y2bh,
     double pi)      // proportion of height growth between breast height
   // ages 0 and 1 that occurs below breast height
+{
+  SI_TRACE_MARK mark;
+  double height;
+
+
+  SI_TRACE_BEGIN (mark);
+  height = si_index_to_height (cu_index, iage, age_type, site_index, y2bh, pi);
+  SI_TRACE_END (mark, SI_TRACE_HEIGHT, cu_index, age_type, -1,
+    iage, NAN, site_index, y2bh, height);
+  return height;
+}
+
+
+static double si_index_to_height (
+    short int cu_index,
+    double iage,
+    short int age_type,
+    double site_index,
+    double y2bh,
+    double pi)
 {
   double height;  // return value
   double x1, x2, x3, x4, x5;  // equation coefficients
@@ -234,12 +271,12 @@ double index_to_height (
   if (age_type == SI_AT_TOTAL)
   {
     tage = iage;
-    bhage = age_to_age (cu_index, tage, SI_AT_TOTAL, SI_AT_BREAST, y2bh);
+    bhage = si_age_to_age (cu_index, tage, SI_AT_TOTAL, SI_AT_BREAST, y2bh);
   }
   else
   {
     bhage = iage;
-    tage = age_to_age (cu_index, bhage, SI_AT_BREAST, SI_AT_TOTAL, y2bh);
+    tage = si_age_to_age (cu_index, bhage, SI_AT_BREAST, SI_AT_TOTAL, y2bh);
   }
   if (tage < 0.0)
     return SI_ERR_NO_ANS;
@@ -411,46 +448,12 @@ double index_to_height (
         /* function starts going nuts at high sites and low ages */
         /* evaluate at a safe age, and interpolate */
         x1 = (site_index - 60) / 1.667 + 0.1;
-        x2 = index_to_height (cu_index, x1, SI_AT_BREAST, site_index, y2bh, pi);
+        x2 = wiley_ht (cu_index, x1, site_index);
         height = 1.37 + (x2-1.37) * bhage / x1;
         break;
       }
 
-      /* convert to imperial */
-      site_index /= 0.3048;
-
-      x1 = 2500 / (site_index - 4.5);
-
-      x2 = -1.7307 + 0.1394 * x1;
-      x3 = -0.0616 + 0.0137 * x1;
-      x4 = 0.00192428 + 0.00007024 * x1;
-
-      height = 4.5 + bhage * bhage / (x2 + x3 * bhage + x4 * bhage * bhage);
-
-      if (bhage < 5)
-        height += (0.3 * bhage);
-      else if (bhage < 10)
-        height += (3.0 - 0.3 * bhage);
-
-      /* convert back to metric */
-      height *= 0.3048;
-
-#ifdef SI_HWC_WILEY_BC
-      if (cu_index == SI_HWC_WILEY_BC)
-      {
-        x1 = -1.34105 + 0.0009 * bhage * height;
-        if (x1 > 0.0)
-          height -= x1;
-      }
-#endif
-
-#ifdef SI_HWC_WILEY_MB
-      if (cu_index == SI_HWC_WILEY_MB)
-      {
-        x1 = 0.0972129 + 0.000419315 * bhage * height;
-        height -= x1;
-      }
-#endif
+      height = wiley_ht (cu_index, bhage, site_index);
     }
     else
       height = tage * tage * 1.37 / y2bh / y2bh;
@@ -466,29 +469,12 @@ double index_to_height (
         /* function starts going nuts at high sites and low ages */
         /* evaluate at a safe age, and interpolate */
         x1 = (site_index - 60) / 1.667 + 0.1 + pi;
-        x2 = index_to_height (cu_index, x1, SI_AT_BREAST, site_index, y2bh, pi);
+        x2 = wileyac_ht (x1, site_index, pi);
         height = 1.37 + (x2-1.37) * (bhage-pi) / x1;
         break;
       }
 
-      /* convert to imperial */
-      site_index /= 0.3048;
-
-      x1 = pow (49 + (1 - pi), 2.0) / (site_index - 4.5);
-
-      x2 = -1.7307 + 0.1394 * x1;
-      x3 = -0.0616 + 0.0137 * x1;
-      x4 = 0.00195078 + 0.00007446 * x1;
-      x5 = bhage - pi;
-      height = 4.5 + x5 * x5 / (x2 + x3 * x5 + x4 * x5 * x5);
-
-      if (x5 < 5)
-        height += (0.3 * x5);
-      else if (x5 < 10)
-        height += (3.0 - 0.3 * x5);
-
-      /* convert back to metric */
-      height *= 0.3048;
+      height = wileyac_ht (bhage, site_index, pi);
     }
     else
       height = tage * tage * 1.37 / y2bh / y2bh;
@@ -1590,38 +1576,12 @@ double index_to_height (
         /* function starts going nuts at high sites and low ages */
         /* evaluate at a safe age, and interpolate */
         x1 = (site_index - 43) / 1.667 + 0.1;
-        x2 = index_to_height (cu_index, x1, SI_AT_BREAST, site_index, y2bh, pi);
+        x2 = kurucz_cw_ht (x1, site_index);
         height = 1.3 + (x2-1.3) * bhage / x1;
         break;
       }
 
-      if (site_index <= 1.3)
-        x1 = 99999.0;
-      else
-        x1 = 2500.0 / (site_index - 1.3);
-
-      x2 = -3.11785 + 0.05027     * x1;
-      x3 = -0.02465 + 0.01411     * x1;
-      x4 =  0.00174 + 0.000097667 * x1;
-
-      height = 1.3 + bhage * bhage / (x2 + x3 * bhage + x4 * bhage * bhage);
-
-      if (bhage > 50.0)
-      {
-        if (bhage > 200)
-        {
-          /*
-          * The "standard" correction applied above 50 years would
-          * overpower the uncorrected curve at around 400 years.
-          * So, after consultation with Robert Macdonald and Ian
-          * Cameron, it was decided to use a correction beyond 200
-          * years with the same ratio as at age 200.
-          */
-          bhage = 200;
-        }
-        height = height - (-0.02379545 * height +
-          0.000475909 * bhage * height);
-      }
+      height = kurucz_cw_ht (bhage, site_index);
     }
     else
       height = tage * tage * 1.3 / y2bh / y2bh;
@@ -1637,38 +1597,12 @@ double index_to_height (
         /* function starts going nuts at high sites and low ages */
         /* evaluate at a safe age, and interpolate */
         x1 = (site_index - 43) / 1.667 + 0.1 + 0.5;
-        x2 = index_to_height (cu_index, x1, SI_AT_BREAST, site_index, y2bh, pi);
+        x2 = kurucz_cwac_ht (x1, site_index);
         height = 1.3 + (x2-1.3) * (bhage-0.5) / x1;
         break;
       }
 
-      if (site_index <= 1.3)
-        x1 = 99999.0;
-      else
-        x1 = 2450.25 / (site_index - 1.3);
-
-      x2 = -3.11785 + 0.05027     * x1;
-      x3 = -0.02465 + 0.01411     * x1;
-      x4 =  0.00177044 + 0.000102554 * x1;
-      x5 = bhage-0.5;
-      height = 1.3 + x5 * x5 / (x2 + x3 * x5 + x4 * x5 * x5);
-
-      if (bhage > 50.0)
-      {
-        if (bhage > 200)
-        {
-          /*
-          * The "standard" correction applied above 50 years would
-          * overpower the uncorrected curve at around 400 years.
-          * So, after consultation with Robert Macdonald and Ian
-          * Cameron, it was decided to use a correction beyond 200
-          * years with the same ratio as at age 200.
-          */
-          bhage = 200;
-        }
-        height = height - (-0.02379545 * height +
-          0.000475909 * bhage * height);
-      }
+      height = kurucz_cwac_ht (bhage, site_index);
     }
     else
       height = tage * tage * 1.3 / y2bh / y2bh;
@@ -1757,28 +1691,12 @@ double index_to_height (
         /* function starts going nuts at high sites and low ages */
         /* evaluate at a safe age, and interpolate */
         x1 = (site_index - 60) / 1.667 + 0.1;
-        x2 = index_to_height (cu_index, x1, SI_AT_BREAST, site_index, y2bh, pi);
+        x2 = kurucz82_ht (x1, site_index);
         height = 1.3 + (x2-1.3) * bhage / x1;
         break;
       }
 
-      if (site_index <= 1.3)
-        x1 = 99999.0;
-      else
-        x1 = 2500.0 / (site_index - 1.3);
-
-      x2 = -2.34655 + 0.0565  * x1;
-      x3 = -0.42007 + 0.01687 * x1;
-      x4 =  0.00934 + 0.00004 * x1;
-
-      height = 1.3 + bhage * bhage / (x2 + x3 * bhage + x4 * bhage * bhage);
-
-      if (bhage < 50.0 && bhage * height < 1695.3)
-      {
-        x1 = 0.45773 - 0.00027 * bhage * height;
-        if (x1 > 0.0)
-          height -= x1;
-      }
+      height = kurucz82_ht (bhage, site_index);
     }
     else
     {
@@ -1800,28 +1718,12 @@ double index_to_height (
         /* function starts going nuts at high sites and low ages */
         /* evaluate at a safe age, and interpolate */
         x1 = (site_index - 60) / 1.667 + 0.1 + 0.5;
-        x2 = index_to_height (cu_index, x1, SI_AT_BREAST, site_index, y2bh, pi);
+        x2 = kurucz82ac_ht (x1, site_index);
         height = 1.3 + (x2-1.3) * (bhage-0.5) / x1;
         break;
       }
 
-      if (site_index <= 1.3)
-        x1 = 99999.0;
-      else
-        x1 = 2450.25 / (site_index - 1.3);
-
-      x2 = -2.09187 + 0.066925  * x1;
-      x3 = -0.42007 + 0.01687 * x1;
-      x4 =  0.00934 + 0.00004 * x1;
-      x5 = bhage-0.5;
-      height = 1.3 + x5 * x5 / (x2 + x3 * x5 + x4 * x5 * x5);
-
-      if (bhage < 50.0 && bhage * height < 1695.3)
-      {
-        x1 = 0.45773 - 0.00027 * bhage * height;
-        if (x1 > 0.0)
-          height -= x1;
-      }
+      height = kurucz82ac_ht (bhage, site_index);
     }
     else
     {
@@ -1982,19 +1884,11 @@ double index_to_height (
       /* function starts going nuts at high sites and low ages */
       /* evaluate at a safe age, and interpolate */
       x1 = (site_index - 45) / 2.5 + 0.1;
-      x2 = index_to_height (cu_index, x1, SI_AT_TOTAL, site_index, y2bh, pi);
+      x2 = harring_ht (x1, site_index);
       height = x2 * tage / x1;
     }
     else
-    {
-      double si20;
-
-      si20 = PPOW (site_index, 1.5) / 8.0;
-      x1 = 18.1622 + 0.7953 * si20;
-      x2 = 0.00194 - 0.002441 * si20;
-      x3 = si20 + x1 * PPOW (1.0 - exp (x2 * tage), 0.9198);
-      height = x3 - x1 * PPOW (1.0 - exp (x2 * 20), 0.9198);
-    }
+      height = harring_ht (tage, site_index);
     break;
 #endif
 
@@ -2778,21 +2672,33 @@ static double gi_si2ht (
   double si2ht;
   double step;
   double test_site;
+  short int end;
+  int n;
+  SI_TRACE_MARK mark;
 
 
   /* breast height age must be at least 1/2 a year */
   if (age < 0.5)
+  {
+    if (SI_TELEMETRY_ON)
+      si_telemetry_solve (SI_SOLVE_GI_HT, cu_index, SI_END_ERROR, SI_ERR_GI_MIN, 0);
     return SI_ERR_GI_MIN;
+  }
+
+  SI_TRACE_BEGIN (mark);
 
   /* initial guess */
   si2ht = site_index;
   if (si2ht < 1.3)
     si2ht = 1.3;
   step = si2ht / 2;
+  n = 0;
 
   /* loop until real close */
   do
   {
+    si_solver_steps++;
+    n++;
     test_site = height_to_index (cu_index, age, SI_AT_BREAST, si2ht, SI_EST_DIRECT);
     /*
     printf ("age=%3.0f, site=%5.2f, test_site=%5.2f, si2ht=%5.2f, step=%9.7f\n",
@@ -2802,6 +2708,7 @@ static double gi_si2ht (
     if (test_site < 0) /* error */
     {
       si2ht = test_site;
+      end = SI_END_ERROR;
       break;
     }
 
@@ -2822,18 +2729,23 @@ static double gi_si2ht (
       si2ht += step;
     }
     else
+    {
       /* done */
+      end = SI_END_CONVERGED;
       break;
+    }
 
     /* check for lack of convergence, so we're not here forever */
     if (step < 0.00001 && step > -0.00001)
     {
       /* we have a value, but perhaps not too accurate */
+      end = SI_END_STEP;
       break;
     }
     if (si2ht > 999.0)
     {
       si2ht = SI_ERR_NO_ANS;
+      end = SI_END_LIMIT;
       break;
     }
     /* site index must be at least 1.3 */
@@ -2847,6 +2759,10 @@ static double gi_si2ht (
     }
   } while (1);
 
+  if (SI_TELEMETRY_ON)
+    si_telemetry_solve (SI_SOLVE_GI_HT, cu_index, end, si2ht, n);
+  SI_TRACE_END (mark, SI_TRACE_SOLVE + SI_SOLVE_GI_HT, cu_index, SI_AT_BREAST, -1,
+    age, NAN, site_index, NAN, si2ht);
   return si2ht;
 }
 #endif
@@ -2855,15 +2771,22 @@ static double gi_si2ht (
 static double hu_garcia_q (double site_index, double bhage)
 {
   double h, q, step, diff, lastdiff;
+  short int end;
+  int n;
+  SI_TRACE_MARK mark;
 
 
+  SI_TRACE_BEGIN (mark);
   q = 0.02;
   step = 0.01;
   lastdiff = 0;
   diff = 0;
+  n = 0;
 
   do
   {
+    si_solver_steps++;
+    n++;
     h = hu_garcia_h (q, bhage);
     lastdiff = diff;
     diff = site_index - h;
@@ -2882,11 +2805,21 @@ static double hu_garcia_q (double site_index, double bhage)
         q = 0.0000001;
     }
     else
+    {
+      end = SI_END_CONVERGED;
       break;
+    }
     if (step < 0.0000001)
+    {
+      end = SI_END_STEP;
       break;
+    }
   } while (1);
 
+  if (SI_TELEMETRY_ON)
+    si_telemetry_solve (SI_SOLVE_HU_GARCIA, SI_SW_HU_GARCIA, end, q, n);
+  SI_TRACE_END (mark, SI_TRACE_SOLVE + SI_SOLVE_HU_GARCIA, SI_SW_HU_GARCIA,
+    SI_AT_BREAST, -1, bhage, NAN, site_index, NAN, q);
   return q;
 }
 
@@ -2900,3 +2833,225 @@ static double hu_garcia_h (double q, double bhage)
   height = a * pow (1 - (1 - pow (1.3 / a, 0.5829)) * exp (-q * (bhage - 0.5)), 1.71556);
   return height;
 }
+
+
+/*
+ * The following compute the unmodified curve bodies for the curves that
+ * need a "safe age" for interpolation at high sites and low ages.
+ * Previously, index_to_height() called itself to get that value.
+ */
+
+static double wiley_ht (short int cu_index, double bhage, double site_index)
+{
+  double height;
+  double x1, x2, x3, x4;
+
+
+  /* convert to imperial */
+  site_index /= 0.3048;
+
+  x1 = 2500 / (site_index - 4.5);
+
+  x2 = -1.7307 + 0.1394 * x1;
+  x3 = -0.0616 + 0.0137 * x1;
+  x4 = 0.00192428 + 0.00007024 * x1;
+
+  height = 4.5 + bhage * bhage / (x2 + x3 * bhage + x4 * bhage * bhage);
+
+  if (bhage < 5)
+    height += (0.3 * bhage);
+  else if (bhage < 10)
+    height += (3.0 - 0.3 * bhage);
+
+  /* convert back to metric */
+  height *= 0.3048;
+
+#ifdef SI_HWC_WILEY_BC
+  if (cu_index == SI_HWC_WILEY_BC)
+  {
+    x1 = -1.34105 + 0.0009 * bhage * height;
+    if (x1 > 0.0)
+      height -= x1;
+  }
+#endif
+
+#ifdef SI_HWC_WILEY_MB
+  if (cu_index == SI_HWC_WILEY_MB)
+  {
+    x1 = 0.0972129 + 0.000419315 * bhage * height;
+    height -= x1;
+  }
+#endif
+
+  return height;
+}
+
+
+static double wileyac_ht (double bhage, double site_index, double pi)
+{
+  double height;
+  double x1, x2, x3, x4, x5;
+
+
+  /* convert to imperial */
+  site_index /= 0.3048;
+
+  x1 = pow (49 + (1 - pi), 2.0) / (site_index - 4.5);
+
+  x2 = -1.7307 + 0.1394 * x1;
+  x3 = -0.0616 + 0.0137 * x1;
+  x4 = 0.00195078 + 0.00007446 * x1;
+  x5 = bhage - pi;
+  height = 4.5 + x5 * x5 / (x2 + x3 * x5 + x4 * x5 * x5);
+
+  if (x5 < 5)
+    height += (0.3 * x5);
+  else if (x5 < 10)
+    height += (3.0 - 0.3 * x5);
+
+  /* convert back to metric */
+  height *= 0.3048;
+
+  return height;
+}
+
+
+static double kurucz_cw_ht (double bhage, double site_index)
+{
+  double height;
+  double x1, x2, x3, x4;
+
+
+  if (site_index <= 1.3)
+    x1 = 99999.0;
+  else
+    x1 = 2500.0 / (site_index - 1.3);
+
+  x2 = -3.11785 + 0.05027     * x1;
+  x3 = -0.02465 + 0.01411     * x1;
+  x4 =  0.00174 + 0.000097667 * x1;
+
+  height = 1.3 + bhage * bhage / (x2 + x3 * bhage + x4 * bhage * bhage);
+
+  if (bhage > 50.0)
+  {
+    if (bhage > 200)
+    {
+      /*
+      * The "standard" correction applied above 50 years would
+      * overpower the uncorrected curve at around 400 years.
+      * So, after consultation with Robert Macdonald and Ian
+      * Cameron, it was decided to use a correction beyond 200
+      * years with the same ratio as at age 200.
+      */
+      bhage = 200;
+    }
+    height = height - (-0.02379545 * height +
+      0.000475909 * bhage * height);
+  }
+
+  return height;
+}
+
+
+static double kurucz_cwac_ht (double bhage, double site_index)
+{
+  double height;
+  double x1, x2, x3, x4, x5;
+
+
+  if (site_index <= 1.3)
+    x1 = 99999.0;
+  else
+    x1 = 2450.25 / (site_index - 1.3);
+
+  x2 = -3.11785 + 0.05027     * x1;
+  x3 = -0.02465 + 0.01411     * x1;
+  x4 =  0.00177044 + 0.000102554 * x1;
+  x5 = bhage-0.5;
+  height = 1.3 + x5 * x5 / (x2 + x3 * x5 + x4 * x5 * x5);
+
+  if (bhage > 50.0)
+  {
+    if (bhage > 200)
+    {
+      /* same correction cap as kurucz_cw_ht() */
+      bhage = 200;
+    }
+    height = height - (-0.02379545 * height +
+      0.000475909 * bhage * height);
+  }
+
+  return height;
+}
+
+
+static double kurucz82_ht (double bhage, double site_index)
+{
+  double height;
+  double x1, x2, x3, x4;
+
+
+  if (site_index <= 1.3)
+    x1 = 99999.0;
+  else
+    x1 = 2500.0 / (site_index - 1.3);
+
+  x2 = -2.34655 + 0.0565  * x1;
+  x3 = -0.42007 + 0.01687 * x1;
+  x4 =  0.00934 + 0.00004 * x1;
+
+  height = 1.3 + bhage * bhage / (x2 + x3 * bhage + x4 * bhage * bhage);
+
+  if (bhage < 50.0 && bhage * height < 1695.3)
+  {
+    x1 = 0.45773 - 0.00027 * bhage * height;
+    if (x1 > 0.0)
+      height -= x1;
+  }
+
+  return height;
+}
+
+
+static double kurucz82ac_ht (double bhage, double site_index)
+{
+  double height;
+  double x1, x2, x3, x4, x5;
+
+
+  if (site_index <= 1.3)
+    x1 = 99999.0;
+  else
+    x1 = 2450.25 / (site_index - 1.3);
+
+  x2 = -2.09187 + 0.066925  * x1;
+  x3 = -0.42007 + 0.01687 * x1;
+  x4 =  0.00934 + 0.00004 * x1;
+  x5 = bhage-0.5;
+  height = 1.3 + x5 * x5 / (x2 + x3 * x5 + x4 * x5 * x5);
+
+  if (bhage < 50.0 && bhage * height < 1695.3)
+  {
+    x1 = 0.45773 - 0.00027 * bhage * height;
+    if (x1 > 0.0)
+      height -= x1;
+  }
+
+  return height;
+}
+
+
+static double harring_ht (double tage, double site_index)
+{
+  double si20;
+  double x1, x2, x3;
+
+
+  si20 = PPOW (site_index, 1.5) / 8.0;
+  x1 = 18.1622 + 0.7953 * si20;
+  x2 = 0.00194 - 0.002441 * si20;
+  x3 = si20 + x1 * PPOW (1.0 - exp (x2 * tage), 0.9198);
+
+  return x3 - x1 * PPOW (1.0 - exp (x2 * 20), 0.9198);
+}
@@ -0,0 +1,387 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * siapprox.c
+ * - fitted site index equations, for curves without a direct one, used
+ *   by height_to_index() for SI_EST_APPROX at breast height age.
+ * - the inverse of the curve is tabulated on a grid in log breast height
+ *   age, from SI_APPROX_AGE_MIN to SI_APPROX_AGE_MAX, and in height
+ *   relative to the heights of site indices SI_APPROX_SI_MIN and
+ *   SI_APPROX_SI_MAX at that age.  Grid values are the exact inverse,
+ *   found by bisection on the curve as site_iterate() uses it, and are
+ *   interpolated by bicubic polynomials.
+ * - each fit is checked against the exact inverse on a grid
+ *   SI_APPROX_CHECK times as fine, edges included.  A grid cell is used
+ *   only if no check point in it or on its edges is off by more than
+ *   SI_APPROX_ACCEPT, so kinks and steps in the curves are left to
+ *   iteration without losing the rest of the curve.
+ * - this is a check, not a bound: the curves are not known to be smooth,
+ *   and between check points the error is not bounded.  SI_APPROX_ACCEPT
+ *   is a quarter of SI_APPROX_TOL to leave room for it; sweeps of every
+ *   curve at 49 points per cell found none over SI_APPROX_TOL, the
+ *   largest being 0.0034 m.
+ * - a curve is fitted on its first use, taking about 0.4 seconds, and
+ *   is read-only afterwards.
+ * - outside the fitted domain, in cells not accepted, or for a curve with
+ *   no fit, si_approx_index() returns SI_ERR_NO_ANS, and the caller
+ *   iterates.
+ *
+ * 2026 oct 18 - Created.
+ *             - NaN ages and heights are outside the fitted domain.
+ *             - Cells are accepted at SI_APPROX_ACCEPT on a grid 6 times
+ *               as fine, not at SI_APPROX_TOL on one 3 times as fine,
+ *               which let errors up to 0.06 m through on stepped curves.
+ */
+
+
+#define SI_APPROX_NA       64     /* grid points in log breast height age */
+#define SI_APPROX_NH       33     /* in relative height */
+#define SI_APPROX_AGE_MIN  5.0
+#define SI_APPROX_AGE_MAX  250.0
+#define SI_APPROX_SI_MIN   3.0
+#define SI_APPROX_SI_MAX   50.0
+#define SI_APPROX_CHECK    6
+#define SI_APPROX_BISECT   45     /* steps, to well under 1e-9 m */
+#define SI_APPROX_TOL      0.01   /* largest error intended (m) */
+#define SI_APPROX_ACCEPT   (SI_APPROX_TOL / 4)   /* on the check grid */
+
+/* why a curve has no fit */
+#define SI_APPROX_OK       0
+#define SI_APPROX_DIRECT   1      /* has a direct equation instead */
+#define SI_APPROX_CODE     2      /* curve gave an error code in the domain */
+#define SI_APPROX_ORDER    3      /* height not increasing with site index */
+#define SI_APPROX_ERROR    4      /* no cell within SI_APPROX_ACCEPT */
+
+typedef struct
+  {
+  int    status;                  /* SI_APPROX_xxx */
+  double max_err;                 /* on the check grid, accepted cells */
+  int    cells;                   /* accepted */
+  double y2bh_lo;                 /* si_y2bh() at SI_APPROX_SI_MIN */
+  double y2bh_hi;                 /* and at SI_APPROX_SI_MAX */
+  double f[SI_APPROX_NA][SI_APPROX_NH];
+  unsigned char ok[SI_APPROX_NA - 1][SI_APPROX_NH - 1];
+  } SI_APPROX;
+
+
+static SI_APPROX si_approx_fit[SI_MAX_CURVES];
+static std::once_flag si_approx_once[SI_MAX_CURVES];
+
+static const char *si_approx_status[] =
+  {
+  "ok", "direct", "error code", "not increasing", "error over tolerance"
+  };
+
+
+/* height as site_iterate() finds it at breast height age */
+static double si_approx_height (short int cu_index, double bhage, double site)
+{
+  return index_to_height (cu_index, bhage, SI_AT_BREAST, site,
+    si_y2bh (cu_index, site), 0.5);
+}
+
+
+/* breast height age to grid position, 0 to SI_APPROX_NA - 1 */
+static double si_approx_x (double bhage)
+{
+  return (SI_APPROX_NA - 1) * (log (bhage) - log (SI_APPROX_AGE_MIN)) /
+    (log (SI_APPROX_AGE_MAX) - log (SI_APPROX_AGE_MIN));
+}
+
+
+static double si_approx_age (double x)
+{
+  return exp (log (SI_APPROX_AGE_MIN) + x / (SI_APPROX_NA - 1) *
+    (log (SI_APPROX_AGE_MAX) - log (SI_APPROX_AGE_MIN)));
+}
+
+
+/*
+ * site index giving height at bhage, by bisection.  Returns an error code
+ * if the curve gives one.
+ */
+static double si_approx_root (
+  short int cu_index,
+  double bhage,
+  double height)
+{
+  double lo, hi, mid, h;
+  int k;
+
+
+  lo = SI_APPROX_SI_MIN;
+  hi = SI_APPROX_SI_MAX;
+  for (k = 0; k < SI_APPROX_BISECT; k++)
+  {
+    mid = (lo + hi) / 2.0;
+    h = si_approx_height (cu_index, bhage, mid);
+    if (h < 0 && h == (int) h)
+      return h;
+    if (h < height)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  return (lo + hi) / 2.0;
+}
+
+
+/*
+ * cubic through the four grid points around position x of a grid of n
+ * points, shifted at the edges to stay within the grid.  Sets the first
+ * point and the four weights.
+ */
+static void si_approx_weights (double x, int n, int *first, double w[4])
+{
+  int k;
+  double t;
+
+
+  k = (int) x - 1;
+  if (k < 0)
+    k = 0;
+  if (k > n - 4)
+    k = n - 4;
+  t = x - k;
+
+  *first = k;
+  w[0] = -(t - 1.0) * (t - 2.0) * (t - 3.0) / 6.0;
+  w[1] = t * (t - 2.0) * (t - 3.0) / 2.0;
+  w[2] = -t * (t - 1.0) * (t - 3.0) / 2.0;
+  w[3] = t * (t - 1.0) * (t - 2.0) / 6.0;
+}
+
+
+/* bicubic interpolation at grid position (x, y) */
+static double si_approx_interp (const SI_APPROX *a, double x, double y)
+{
+  double wx[4], wy[4];
+  double sum, row;
+  int i, j, k, l;
+
+
+  si_approx_weights (x, SI_APPROX_NA, &i, wx);
+  si_approx_weights (y, SI_APPROX_NH, &j, wy);
+
+  sum = 0;
+  for (k = 0; k < 4; k++)
+  {
+    row = 0;
+    for (l = 0; l < 4; l++)
+      row += a->f[i + k][j + l] * wy[l];
+    sum += row * wx[k];
+  }
+
+  return sum;
+}
+
+
+/*
+ * heights of the domain's least and greatest site index at bhage.
+ * Returns 0 if the curve gives an error code or they are out of order.
+ */
+static int si_approx_bounds (
+  short int cu_index,
+  const SI_APPROX *a,
+  double bhage,
+  double *lo,
+  double *hi)
+{
+  *lo = index_to_height (cu_index, bhage, SI_AT_BREAST, SI_APPROX_SI_MIN,
+    a->y2bh_lo, 0.5);
+  *hi = index_to_height (cu_index, bhage, SI_AT_BREAST, SI_APPROX_SI_MAX,
+    a->y2bh_hi, 0.5);
+
+  return *lo >= 0 && *hi > *lo;
+}
+
+
+static void si_approx_build (short int cu_index)
+{
+  SI_APPROX *a;
+  const SI_CURVE *cu;
+  std::vector<double> err;
+  double bhage, lo, hi, y, s, e;
+  int i, j, k, l, ni, nj;
+
+
+  a = &si_approx_fit[cu_index];
+  cu = si_curve (cu_index);
+  a->max_err = NA_REAL;
+  a->cells = 0;
+  if (cu->direct)
+  {
+    a->status = SI_APPROX_DIRECT;
+    return;
+  }
+
+  a->y2bh_lo = si_y2bh (cu_index, SI_APPROX_SI_MIN);
+  a->y2bh_hi = si_y2bh (cu_index, SI_APPROX_SI_MAX);
+
+  /* exact inverse at the grid points */
+  for (i = 0; i < SI_APPROX_NA; i++)
+  {
+    bhage = si_approx_age (i);
+    if (!si_approx_bounds (cu_index, a, bhage, &lo, &hi))
+    {
+      a->status = (lo < 0 || hi < 0) ? SI_APPROX_CODE : SI_APPROX_ORDER;
+      return;
+    }
+    for (j = 0; j < SI_APPROX_NH; j++)
+    {
+      a->f[i][j] = si_approx_root (cu_index, bhage,
+        lo + (double) j / (SI_APPROX_NH - 1) * (hi - lo));
+      if (a->f[i][j] < 0)
+      {
+        a->status = SI_APPROX_CODE;
+        return;
+      }
+    }
+  }
+
+  /* errors on a finer grid, edges included */
+  ni = SI_APPROX_CHECK * (SI_APPROX_NA - 1);
+  nj = SI_APPROX_CHECK * (SI_APPROX_NH - 1);
+  err.resize ((size_t) (ni + 1) * (nj + 1));
+  for (i = 0; i <= ni; i++)
+  {
+    bhage = si_approx_age ((double) i / SI_APPROX_CHECK);
+    if (!si_approx_bounds (cu_index, a, bhage, &lo, &hi))
+    {
+      a->status = (lo < 0 || hi < 0) ? SI_APPROX_CODE : SI_APPROX_ORDER;
+      return;
+    }
+    for (j = 0; j <= nj; j++)
+    {
+      y = (double) j / SI_APPROX_CHECK;
+      s = si_approx_root (cu_index, bhage,
+        lo + y / (SI_APPROX_NH - 1) * (hi - lo));
+      if (s < 0)
+      {
+        a->status = SI_APPROX_CODE;
+        return;
+      }
+      err[(size_t) i * (nj + 1) + j] =
+        fabs (si_approx_interp (a, si_approx_x (bhage), y) - s);
+    }
+  }
+
+  /* a cell is accepted if no check point in it or on its edges is over */
+  a->max_err = 0;
+  for (k = 0; k < SI_APPROX_NA - 1; k++)
+    for (l = 0; l < SI_APPROX_NH - 1; l++)
+    {
+      e = 0;
+      for (i = k * SI_APPROX_CHECK; i <= (k + 1) * SI_APPROX_CHECK; i++)
+        for (j = l * SI_APPROX_CHECK; j <= (l + 1) * SI_APPROX_CHECK; j++)
+          if (err[(size_t) i * (nj + 1) + j] > e)
+            e = err[(size_t) i * (nj + 1) + j];
+      a->ok[k][l] = (e <= SI_APPROX_ACCEPT);
+      if (a->ok[k][l])
+      {
+        a->cells++;
+        if (e > a->max_err)
+          a->max_err = e;
+      }
+    }
+
+  if (a->cells == 0)
+  {
+    a->max_err = NA_REAL;
+    a->status = SI_APPROX_ERROR;
+    return;
+  }
+  a->status = SI_APPROX_OK;
+}
+
+
+static const SI_APPROX *si_approx (short int cu_index)
+{
+  std::call_once (si_approx_once[cu_index], si_approx_build, cu_index);
+  return &si_approx_fit[cu_index];
+}
+
+
+/*
+ * site index from height and breast height age by the curve's fitted
+ * equation.  Returns SI_ERR_NO_ANS if the curve has no fit, or the
+ * inputs are outside its domain.  The range tests are written so that
+ * NaN inputs fail them, as they must before indexing the grid.
+ */
+double si_approx_index (
+  short int cu_index,
+  double bhage,
+  double height)
+{
+  const SI_APPROX *a;
+  double lo, hi, x, y;
+  int i, j;
+
+
+  if (cu_index < 0 || cu_index >= SI_MAX_CURVES ||
+      !(bhage >= SI_APPROX_AGE_MIN && bhage <= SI_APPROX_AGE_MAX))
+    return SI_ERR_NO_ANS;
+
+  a = si_approx (cu_index);
+  if (a->status != SI_APPROX_OK)
+    return SI_ERR_NO_ANS;
+
+  if (!si_approx_bounds (cu_index, a, bhage, &lo, &hi) ||
+      !(height >= lo && height <= hi))
+    return SI_ERR_NO_ANS;
+
+  x = si_approx_x (bhage);
+  y = (SI_APPROX_NH - 1) * (height - lo) / (hi - lo);
+  i = std::min ((int) x, SI_APPROX_NA - 2);
+  j = std::min ((int) y, SI_APPROX_NH - 2);
+  if (!a->ok[i][j])
+    return SI_ERR_NO_ANS;
+
+  return si_approx_interp (a, x, y);
+}
+
+
+/*
+ * fits every curve, and reports each fit: its status, the share of grid
+ * cells accepted, and the largest error found in them on the check grid.
+ */
+// [[Rcpp::export]]
+DataFrame Sindex_ApproxReport ()
+{
+  const SI_APPROX *a;
+  int c;
+
+  IntegerVector out_curve (SI_MAX_CURVES);
+  CharacterVector out_name (SI_MAX_CURVES);
+  CharacterVector out_status (SI_MAX_CURVES);
+  NumericVector out_cells (SI_MAX_CURVES);
+  NumericVector out_err (SI_MAX_CURVES);
+
+
+  for (c = 0; c < SI_MAX_CURVES; c++)
+  {
+    a = si_approx ((short int) c);
+    out_curve[c] = c;
+    out_name[c] = si_curve ((short int) c)->name;
+    out_status[c] = si_approx_status[a->status];
+    out_cells[c] = (double) a->cells /
+      ((SI_APPROX_NA - 1) * (SI_APPROX_NH - 1));
+    out_err[c] = a->max_err;
+  }
+
+  return DataFrame::create (
+    Named ("curve") = out_curve,
+    Named ("name") = out_name,
+    Named ("status") = out_status,
+    Named ("accepted") = out_cells,
+    Named ("max_err") = out_err,
+    Named ("stringsAsFactors") = false);
+}
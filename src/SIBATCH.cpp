@@ -0,0 +1,649 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * sibatch.c
+ * - batch versions of the Sindex functions, taking columns of inputs.
+ * - rows are grouped by curve, and each group is handed to the curve's
+ *   batch kernel from the curve registry.
+ * - results and error codes are as for the single-row functions.
+ *
+ * 2026 oct 18 - Created, with batch height from age and site index.
+ *             - Added batch site index from height and age.  Rows that
+ *               need iterating are solved in lockstep, SI_LANES at a
+ *               time, with the curve's batch kernel giving the heights
+ *               for all lanes at each step.
+ *             - Added math tier to both, choosing the curves' kernels.
+ *             - Added single precision versions of both, taking and
+ *               returning floats, and Sindex_FloatReport() to compare
+ *               them with double precision.
+ *             - Lockstep solves add to si_solver_steps.
+ *             - Lockstep solves are counted for telemetry, as
+ *               site_iterate().
+ *             - Added si_split_codes(), and batch height and site index
+ *               returning values and error codes in separate columns.
+ *             - SI_EST_APPROX rows use the curve's fitted equation where
+ *               accepted, and are solved in lockstep elsewhere.  At
+ *               total age they are solved singly by total_iterate().
+ *             - Added batch age from height and site index, with rows
+ *               solved a curve at a time.
+ *             - Batch height takes long runs of one curve in place, and
+ *               otherwise gathers rows a few at a time.
+ *             - Dropped the lockstep solves, which ran each lane's step
+ *               alone and were slower than height_to_index().  Rows
+ *               that need iterating are solved one at a time by
+ *               height_to_index(), at every math tier.
+ *             - Dropped Sindex_AgeSIToHtBatchF() and
+ *               Sindex_HtAgeToSIBatchF(), which copied through double
+ *               and so were no faster from R than the FAST tier.  The
+ *               single precision functions stay for callers in C, with
+ *               Sindex_FloatReport() comparing them with double.
+ *             - Removed the single precision functions and
+ *               Sindex_FloatReport().  Only kernel curves were computed
+ *               in float; other curves and iterated rows were computed
+ *               in double and rounded.
+ *             - Rows of kernel curves that need iterating are solved in
+ *               lockstep again, SI_LANES at a time, with each lane's
+ *               inputs copied in once and heights from the curve's
+ *               kernel at the math tier.  Results are as
+ *               height_to_index() at the EXACT tier.
+ */
+
+
+/* rows gathered for each kernel call, when rows of curves are mixed */
+#define SI_GATHER_ROWS 256
+
+/* least mean length of runs of one curve to take rows where they are */
+#define SI_RUN_ROWS 32
+
+/* number of solves run in lockstep */
+#define SI_LANES 64
+
+
+void si_group_rows (
+  int n,
+  const int *cu_index,
+  int *start,
+  int *perm)
+{
+  int i, g;
+  short int cu;
+
+
+  for (g = 0; g < SI_MAX_CURVES + 2; g++)
+    start[g] = 0;
+
+  /* count rows per curve, unknown curves go in the last group */
+  for (i = 0; i < n; i++)
+  {
+    cu = (short int) cu_index[i];
+    if (cu < 0 || cu >= SI_MAX_CURVES)
+      cu = SI_MAX_CURVES;
+    start[cu + 1]++;
+  }
+  for (g = 1; g < SI_MAX_CURVES + 2; g++)
+    start[g] += start[g - 1];
+
+  /* place rows, keeping their order within each group */
+  std::vector<int> next (start, start + SI_MAX_CURVES + 1);
+  for (i = 0; i < n; i++)
+  {
+    cu = (short int) cu_index[i];
+    if (cu < 0 || cu >= SI_MAX_CURVES)
+      cu = SI_MAX_CURVES;
+    perm[next[cu]++] = i;
+  }
+}
+
+
+/*
+ * heights from age and site index.  Rows that come in long runs of one
+ * curve, as when all rows share a curve, go to the kernel where they
+ * are.  Otherwise rows are grouped by curve and gathered a few at a
+ * time, so the copies stay in cache.
+ */
+void si_height_batch (
+  int n,
+  const int *cu_index,
+  const double *age,
+  const int *age_type,
+  const double *site_index,
+  const double *y2bh,
+  double pi,
+  int tier,
+  double *height)
+{
+  double g_age[SI_GATHER_ROWS], g_si[SI_GATHER_ROWS], g_y2bh[SI_GATHER_ROWS];
+  double g_ht[SI_GATHER_ROWS];
+  int g_type[SI_GATHER_ROWS];
+  int g, i, j, k, m, runs;
+  const SI_CURVE *cu;
+
+
+  runs = 0;
+  for (i = 0; i < n; i++)
+    if (i == 0 || cu_index[i] != cu_index[i - 1])
+      runs++;
+
+  if ((long) runs * SI_RUN_ROWS <= n)
+  {
+    for (i = 0; i < n; i = j)
+    {
+      for (j = i + 1; j < n && cu_index[j] == cu_index[i]; j++)
+        ;
+      cu = si_curve ((short int) cu_index[i]);
+      if (cu != NULL)
+        cu->height_tier[tier] ((short int) cu_index[i], j - i,
+          age + i, age_type + i, site_index + i, y2bh + i, pi, height + i);
+      else
+        for (k = i; k < j; k++)
+          height[k] = index_to_height ((short int) cu_index[k], age[k],
+            (short int) age_type[k], site_index[k], y2bh[k], pi);
+    }
+    return;
+  }
+
+  std::vector<int> start (SI_MAX_CURVES + 2);
+  std::vector<int> perm (n);
+  si_group_rows (n, cu_index, start.data (), perm.data ());
+
+  for (g = 0; g < SI_MAX_CURVES; g++)
+  {
+    cu = si_curve ((short int) g);
+    for (k = start[g]; k < start[g + 1]; k += m)
+    {
+      m = std::min (start[g + 1] - k, SI_GATHER_ROWS);
+      for (j = 0; j < m; j++)
+      {
+        i = perm[k + j];
+        g_age[j] = age[i];
+        g_type[j] = age_type[i];
+        g_si[j] = site_index[i];
+        g_y2bh[j] = y2bh[i];
+      }
+
+      cu->height_tier[tier] ((short int) g, m, g_age, g_type, g_si, g_y2bh,
+        pi, g_ht);
+
+      for (j = 0; j < m; j++)
+        height[perm[k + j]] = g_ht[j];
+    }
+  }
+
+  /* unknown curves, error codes as from index_to_height() */
+  for (j = start[SI_MAX_CURVES]; j < start[SI_MAX_CURVES + 1]; j++)
+  {
+    i = perm[j];
+    height[i] = index_to_height ((short int) cu_index[i], age[i],
+      (short int) age_type[i], site_index[i], y2bh[i], pi);
+  }
+}
+
+
+/* puts row i in lane l, with site_iterate()'s initial guess */
+static void si_lane_start (
+  int l,
+  int i,
+  const double *age,
+  const int *age_type,
+  const double *height,
+  int *row,
+  int *l_type,
+  double *l_age,
+  double *l_height,
+  double *site,
+  double *step,
+  int *steps)
+{
+  row[l] = i;
+  l_type[l] = age_type[i];
+  l_age[l] = age[i];
+  l_height[l] = height[i];
+  site[l] = height[i];
+  if (site[l] < 1.3)
+    site[l] = 1.3;
+  step[l] = site[l]/2.0;
+  steps[l] = 0;
+}
+
+
+/*
+ * site indices by site_iterate()'s search, for rows of one curve with
+ * kernels, run in lockstep SI_LANES rows at a time.  Each step takes
+ * y2bh for every busy lane, then all of their heights from one call of
+ * the curve's kernel for the tier, so the kernel's loop is vectorised
+ * across lanes.  A lane that ends takes the next row, or the last busy
+ * lane, so busy lanes stay in front.  Each lane steps as site_iterate()
+ * does; at SI_MATH_EXACT the kernels give index_to_height()'s heights,
+ * and results are bit-identical to height_to_index().
+ */
+static void si_index_lockstep (
+  short int cu_index,
+  int tier,
+  int m,
+  const int *rows,
+  const double *age,
+  const int *age_type,
+  const double *height,
+  double *index)
+{
+  const SI_CURVE *cu;
+  int    row[SI_LANES];
+  int    l_type[SI_LANES];   /* the row's inputs, kept in the lane */
+  double l_age[SI_LANES];
+  double l_height[SI_LANES];
+  double site[SI_LANES];
+  double step[SI_LANES];
+  double y2bh[SI_LANES];
+  double bhage[SI_LANES];
+  double test_top[SI_LANES];
+  int    k_type[SI_LANES];
+  int    steps[SI_LANES];
+  int    next, busy, l;
+  short int end;
+
+
+  cu = si_curve (cu_index);
+  for (l = 0; l < SI_LANES; l++)
+    k_type[l] = SI_AT_BREAST;
+
+  next = 0;
+  for (busy = 0; busy < SI_LANES && next < m; busy++)
+    si_lane_start (busy, rows[next++], age, age_type, height, row, l_type,
+      l_age, l_height, site, step, steps);
+
+  while (busy > 0)
+  {
+    /* estimate y2bh */
+    for (l = 0; l < busy; l++)
+    {
+      y2bh[l] = si_y2bh (cu_index, site[l]);
+      if (l_type[l] == SI_AT_BREAST)
+        bhage[l] = l_age[l];
+      else
+        bhage[l] = si_age_to_age (cu_index, l_age[l], SI_AT_TOTAL,
+          SI_AT_BREAST, y2bh[l]);
+    }
+    si_solver_steps += busy;
+
+    cu->height_tier[tier] (cu_index, busy, bhage, k_type, site, y2bh, 0.5,
+      test_top);
+
+    /* down, so the lane moved in from the end has had its step */
+    for (l = busy - 1; l >= 0; l--)
+    {
+      steps[l]++;
+      end = -1;
+
+      if (l_type[l] != SI_AT_BREAST && y2bh[l] == SI_ERR_GI_TOT)
+      {
+        /* cannot do this for GI equations */
+        site[l] = SI_ERR_GI_TOT;
+        end = SI_END_ERROR;
+      }
+      else if (test_top[l] == SI_ERR_CURVE ||
+               test_top[l] == SI_ERR_GI_MAX ||
+               test_top[l] == SI_ERR_GI_MIN)
+      {
+        site[l] = test_top[l];
+        end = SI_END_ERROR;
+      }
+      else
+      {
+        if (test_top[l] == SI_ERR_NO_ANS) /* height > 999 */
+          site[l] = 1000; /* should force an error code */
+
+        if ((test_top[l] - l_height[l] > 0.01) ||
+            (test_top[l] - l_height[l] < -0.01))
+        {
+          /*
+           * not close enough: halve and turn the step if it goes the wrong
+           * way, by selects, as the lanes go either way at random
+           */
+          step[l] *= ((test_top[l] > l_height[l]) ?
+            (step[l] > 0) : (step[l] < 0)) ? -0.5 : 1.0;
+          site[l] += step[l];
+
+          if (step[l] < 0.00001 && step[l] > -0.00001)
+            end = SI_END_STEP;
+          else if (site[l] > 999.0)
+          {
+            site[l] = SI_ERR_NO_ANS;
+            end = SI_END_LIMIT;
+          }
+          else if (site[l] < 1.3)
+          {
+            /* site index must be at least 1.3 */
+            if (step[l] > 0)
+              site[l] += step[l];
+            else
+              site[l] -= step[l];
+            step[l] = step[l] / 2.0;
+          }
+        }
+        else
+          end = SI_END_CONVERGED;
+      }
+
+      if (end < 0)
+        continue;
+
+      index[row[l]] = site[l];
+      if (SI_TELEMETRY_ON)
+        si_telemetry_solve (SI_SOLVE_SITE, cu_index, end, site[l], steps[l]);
+
+      if (next < m)
+        si_lane_start (l, rows[next++], age, age_type, height, row, l_type,
+          l_age, l_height, site, step, steps);
+      else
+      {
+        busy--;
+        row[l] = row[busy];
+        l_type[l] = l_type[busy];
+        l_age[l] = l_age[busy];
+        l_height[l] = l_height[busy];
+        site[l] = site[busy];
+        step[l] = step[busy];
+        steps[l] = steps[busy];
+      }
+    }
+  }
+}
+
+
+/*
+ * site indices from height and age.  Rows of curves with kernels that
+ * need site_iterate() are solved in lockstep, with heights at the math
+ * tier; other rows that need iterating are solved by height_to_index().
+ * While calls are traced, all rows go to height_to_index(), so each is
+ * recorded.
+ */
+void si_index_batch (
+  int n,
+  const int *cu_index,
+  const double *age,
+  const int *age_type,
+  const double *height,
+  const int *est_type,
+  int tier,
+  double *index)
+{
+  std::vector<int> start (SI_MAX_CURVES + 2);
+  std::vector<int> perm (n);
+  std::vector<int> rows;
+  int g, i, j, lockstep;
+  double a;
+  const SI_CURVE *cu;
+
+
+  si_group_rows (n, cu_index, start.data (), perm.data ());
+  lockstep = !si_trace.load (std::memory_order_relaxed);
+
+  for (g = 0; g < SI_MAX_CURVES; g++)
+  {
+    cu = si_curve ((short int) g);
+    rows.clear ();
+
+    for (j = start[g]; j < start[g + 1]; j++)
+    {
+      i = perm[j];
+
+      /* simple cases, as in height_to_index() */
+      if (age_type[i] == SI_AT_BREAST)
+      {
+        if (height[i] < 1.3)
+        {
+          index[i] = SI_ERR_LT13;
+          continue;
+        }
+      }
+      else if (height[i] <= 0)
+      {
+        index[i] = SI_ERR_NO_ANS;
+        continue;
+      }
+      if (age[i] <= 0)
+      {
+        index[i] = SI_ERR_NO_ANS;
+        continue;
+      }
+
+      if (age_type[i] == SI_AT_BREAST)
+      {
+        if (age[i] <= 0.5)
+        {
+          index[i] = SI_ERR_GI_MIN;
+          continue;
+        }
+        if ((est_type[i] == SI_EST_DIRECT || est_type[i] == SI_EST_APPROX) &&
+            cu->direct)
+        {
+          index[i] = height_to_index ((short int) g, age[i], SI_AT_BREAST,
+            height[i], SI_EST_DIRECT);
+          continue;
+        }
+        if (est_type[i] == SI_EST_APPROX)
+        {
+          a = si_approx_index ((short int) g, age[i], height[i]);
+          if (a != SI_ERR_NO_ANS)
+          {
+            index[i] = a;
+            continue;
+          }
+        }
+      }
+#ifdef SI_FDI_THROWER
+      else if (est_type[i] == SI_EST_DIRECT && g == SI_FDI_THROWER)
+      {
+        index[i] = height_to_index ((short int) g, age[i], SI_AT_TOTAL,
+          height[i], SI_EST_DIRECT);
+        continue;
+      }
+#endif
+      else if (est_type[i] == SI_EST_APPROX)
+      {
+        index[i] = height_to_index ((short int) g, age[i], SI_AT_TOTAL,
+          height[i], SI_EST_APPROX);
+        continue;
+      }
+
+      /* by site_iterate() */
+      if (lockstep && cu->kernel)
+        rows.push_back (i);
+      else
+        index[i] = height_to_index ((short int) g, age[i],
+          (short int) age_type[i], height[i], SI_EST_ITERATE);
+    }
+
+    if (!rows.empty ())
+      si_index_lockstep ((short int) g, tier, (int) rows.size (),
+        rows.data (), age, age_type, height, index);
+  }
+
+  /* unknown curves, error codes as from height_to_index() */
+  for (j = start[SI_MAX_CURVES]; j < start[SI_MAX_CURVES + 1]; j++)
+  {
+    i = perm[j];
+    index[i] = height_to_index ((short int) cu_index[i], age[i],
+      (short int) age_type[i], height[i], (short int) est_type[i]);
+  }
+}
+
+
+/*
+ * ages from height and site index.  Rows are solved by index_to_age() a
+ * curve at a time, so what a curve sets up on first use, such as the
+ * search ranges of gi_iterate(), is set up once and kept at hand.
+ */
+void si_age_batch (
+  int n,
+  const int *cu_index,
+  const double *height,
+  const int *age_type,
+  const double *site_index,
+  const double *y2bh,
+  double *age)
+{
+  std::vector<int> start (SI_MAX_CURVES + 2);
+  std::vector<int> perm (n);
+  int j, i;
+
+
+  si_group_rows (n, cu_index, start.data (), perm.data ());
+
+  /* unknown curves last, error codes as from index_to_age() */
+  for (j = 0; j < n; j++)
+  {
+    i = perm[j];
+    age[i] = index_to_age ((short int) cu_index[i], height[i],
+      (short int) age_type[i], site_index[i], y2bh[i]);
+  }
+}
+
+
+/*
+ * moves the error codes out of a column of results into code, one byte a
+ * row, leaving missing in their place.  code is 0 for rows with values.
+ */
+void si_split_codes (
+  int n,
+  double *value,
+  signed char *code,
+  double missing)
+{
+  int i;
+  double x;
+
+
+  for (i = 0; i < n; i++)
+  {
+    x = value[i];
+    code[i] = (x <= SI_ERR_LT13 && x >= SI_ERR_ESTAB && x == (int) x) ?
+      (signed char) x : 0;
+    value[i] = (code[i] != 0) ? missing : x;
+  }
+}
+
+
+// [[Rcpp::export]]
+NumericVector Sindex_AgeSIToHtBatch (
+    IntegerVector cu_index,
+    NumericVector age,
+    IntegerVector age_type,
+    NumericVector site_index,
+    NumericVector y2bh,
+    double pi,
+    int tier = 0)
+{
+  int n = cu_index.size ();
+
+
+  if (age.size () != n || age_type.size () != n ||
+      site_index.size () != n || y2bh.size () != n)
+    stop ("all inputs must have the same length");
+  if (tier < 0 || tier >= SI_MATH_TIERS)
+    stop ("unknown math tier");
+
+  NumericVector height (n);
+  si_height_batch (n, cu_index.begin (), age.begin (), age_type.begin (),
+    site_index.begin (), y2bh.begin (), pi, tier, height.begin ());
+
+  return height;
+}
+
+
+// [[Rcpp::export]]
+NumericVector Sindex_HtAgeToSIBatch (
+    IntegerVector cu_index,
+    NumericVector age,
+    IntegerVector age_type,
+    NumericVector height,
+    IntegerVector est_type,
+    int tier = 0)
+{
+  int n = cu_index.size ();
+
+
+  if (age.size () != n || age_type.size () != n ||
+      height.size () != n || est_type.size () != n)
+    stop ("all inputs must have the same length");
+  if (tier < 0 || tier >= SI_MATH_TIERS)
+    stop ("unknown math tier");
+
+  NumericVector index (n);
+  si_index_batch (n, cu_index.begin (), age.begin (), age_type.begin (),
+    height.begin (), est_type.begin (), tier, index.begin ());
+
+  return index;
+}
+
+
+// [[Rcpp::export]]
+NumericVector Sindex_HtSIToAgeBatch (
+    IntegerVector cu_index,
+    NumericVector height,
+    IntegerVector age_type,
+    NumericVector site_index,
+    NumericVector y2bh)
+{
+  int n = cu_index.size ();
+
+
+  if (height.size () != n || age_type.size () != n ||
+      site_index.size () != n || y2bh.size () != n)
+    stop ("all inputs must have the same length");
+
+  NumericVector age (n);
+  si_age_batch (n, cu_index.begin (), height.begin (), age_type.begin (),
+    site_index.begin (), y2bh.begin (), age.begin ());
+
+  return age;
+}
+
+
+/* a value column, NA for errors, and an error column, 0 or SI_ERR_xxx */
+static DataFrame si_coded_frame (NumericVector value)
+{
+  std::vector<signed char> code (value.size ());
+
+
+  si_split_codes (value.size (), value.begin (), code.data (), NA_REAL);
+
+  return DataFrame::create (
+    Named ("value") = value,
+    Named ("error") = IntegerVector (code.begin (), code.end ()));
+}
+
+
+// [[Rcpp::export]]
+DataFrame Sindex_AgeSIToHtCoded (
+    IntegerVector cu_index,
+    NumericVector age,
+    IntegerVector age_type,
+    NumericVector site_index,
+    NumericVector y2bh,
+    double pi,
+    int tier = 0)
+{
+  return si_coded_frame (Sindex_AgeSIToHtBatch (cu_index, age, age_type,
+    site_index, y2bh, pi, tier));
+}
+
+
+// [[Rcpp::export]]
+DataFrame Sindex_HtAgeToSICoded (
+    IntegerVector cu_index,
+    NumericVector age,
+    IntegerVector age_type,
+    NumericVector height,
+    IntegerVector est_type,
+    int tier = 0)
+{
+  return si_coded_frame (Sindex_HtAgeToSIBatch (cu_index, age, age_type,
+    height, est_type, tier));
+}
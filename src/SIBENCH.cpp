@@ -0,0 +1,271 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * sibench.c
+ * - microbenchmark of the Sindex entry points, curve by curve.
+ * - each entry point is called over a grid of inputs for the curve: site
+ *   indices 5 to 45 m by 5 and ages 10 to 150 years by 10.  Heights come
+ *   from index_to_height() on the same grid, so the solvers are given
+ *   problems with answers.
+ * - throughput is the mean time per call over repeated passes of the
+ *   grid.  Latency is from timing single calls, less the time to read the
+ *   clock, given as the median and 99th percentile.
+ * - iterations are solver steps per call, from si_solver_steps.  errors
+ *   counts the grid points giving an error code.
+ * - the result has one row per curve and case, with the SINDEX version,
+ *   so runs can be saved and compared between versions.
+ *
+ * 2026 oct 18 - Created.
+ *             - Added site index by SI_EST_APPROX, with a first call of
+ *               each case before timing, as curves are fitted on first use.
+ *             - Added site index from total age by SI_EST_APPROX.
+ */
+
+
+thread_local unsigned long si_solver_steps = 0;
+
+/* as defined in specrmap.c and sindxdll.c */
+short int species_remap (std::string, char);
+short int Sindex_VersionNumber ();
+
+/* entry points */
+#define SI_BENCH_HEIGHT   0
+#define SI_BENCH_INDEX    1
+#define SI_BENCH_AGE      2
+#define SI_BENCH_Y2BH     3
+#define SI_BENCH_AGE2AGE  4
+#define SI_BENCH_CLASS    5
+#define SI_BENCH_REMAP    6
+
+typedef struct
+  {
+  short int   call;       /* SI_BENCH_xxx */
+  const char *entry;
+  short int   age_type;   /* -1 if not an argument */
+  short int   est_type;   /* -1 if not an argument */
+  } SI_BENCH_CASE;
+
+static const SI_BENCH_CASE si_bench_case[] =
+  {
+  { SI_BENCH_HEIGHT,  "index_to_height", SI_AT_TOTAL,  -1 },
+  { SI_BENCH_HEIGHT,  "index_to_height", SI_AT_BREAST, -1 },
+  { SI_BENCH_INDEX,   "height_to_index", SI_AT_TOTAL,  SI_EST_DIRECT },
+  { SI_BENCH_INDEX,   "height_to_index", SI_AT_TOTAL,  SI_EST_ITERATE },
+  { SI_BENCH_INDEX,   "height_to_index", SI_AT_TOTAL,  SI_EST_APPROX },
+  { SI_BENCH_INDEX,   "height_to_index", SI_AT_BREAST, SI_EST_DIRECT },
+  { SI_BENCH_INDEX,   "height_to_index", SI_AT_BREAST, SI_EST_ITERATE },
+  { SI_BENCH_INDEX,   "height_to_index", SI_AT_BREAST, SI_EST_APPROX },
+  { SI_BENCH_AGE,     "index_to_age",    SI_AT_TOTAL,  -1 },
+  { SI_BENCH_AGE,     "index_to_age",    SI_AT_BREAST, -1 },
+  { SI_BENCH_Y2BH,    "si_y2bh",         -1,           -1 },
+  { SI_BENCH_AGE2AGE, "age_to_age",      SI_AT_TOTAL,  -1 },   /* to breast */
+  { SI_BENCH_AGE2AGE, "age_to_age",      SI_AT_BREAST, -1 },   /* to total */
+  { SI_BENCH_CLASS,   "class_to_index",  -1,           -1 },
+  { SI_BENCH_REMAP,   "species_remap",   -1,           -1 },
+  };
+
+#define SI_BENCH_CASES ((int) (sizeof (si_bench_case) / sizeof (si_bench_case[0])))
+
+/* one grid point of a curve */
+typedef struct
+  {
+  double age;
+  double si;
+  double y2bh;
+  double height[2];   /* at total and breast height age */
+  char   sitecl;
+  char   fiz;
+  } SI_BENCH_ROW;
+
+static volatile double si_bench_sink;
+
+
+static double si_bench_call (
+  const SI_BENCH_CASE *bc,
+  short int cu_index,
+  const SI_CURVE *cu,
+  const SI_BENCH_ROW *row,
+  const std::string &code)
+{
+  switch (bc->call)
+  {
+    case SI_BENCH_HEIGHT:
+      return index_to_height (cu_index, row->age, bc->age_type, row->si,
+        row->y2bh, 0.5);
+    case SI_BENCH_INDEX:
+      return height_to_index (cu_index, row->age, bc->age_type,
+        row->height[bc->age_type], bc->est_type);
+    case SI_BENCH_AGE:
+      return index_to_age (cu_index, row->height[bc->age_type], bc->age_type,
+        row->si, row->y2bh);
+    case SI_BENCH_Y2BH:
+      return si_y2bh (cu_index, row->si);
+    case SI_BENCH_AGE2AGE:
+      return age_to_age (cu_index, row->age, bc->age_type,
+        (short int) (SI_AT_TOTAL + SI_AT_BREAST - bc->age_type), row->y2bh);
+    case SI_BENCH_CLASS:
+      return class_to_index (cu->sp_index, row->sitecl, row->fiz);
+    case SI_BENCH_REMAP:
+      return species_remap (code, row->fiz);
+  }
+
+  return SI_ERR_NO_ANS;
+}
+
+
+/*
+ * times every case for every curve.  reps is the number of passes of
+ * each curve's grid, for both throughput and latency.
+ */
+// [[Rcpp::export]]
+DataFrame Sindex_Benchmark (int reps)
+{
+  static const char si_bench_class[4] = { 'G', 'M', 'P', 'L' };
+  static const char si_bench_fiz[4] = { 'A', 'C', 'E', 'J' };
+  std::vector<SI_BENCH_ROW> grid;
+  std::vector<double> lat;
+  SI_BENCH_ROW row;
+  std::string code;
+  const SI_CURVE *cu;
+  const SI_BENCH_CASE *bc;
+  int c, k, p, r, i, n, errors, rows;
+  unsigned long steps, most;
+  double a, s, sum, overhead;
+  std::chrono::steady_clock::time_point t0, t1;
+
+  rows = SI_MAX_CURVES * SI_BENCH_CASES;
+  IntegerVector out_version (rows, (int) Sindex_VersionNumber ());
+  IntegerVector out_curve (rows);
+  CharacterVector out_name (rows);
+  CharacterVector out_entry (rows);
+  IntegerVector out_age_type (rows);
+  IntegerVector out_est_type (rows);
+  IntegerVector out_calls (rows);
+  NumericVector out_ns (rows);
+  NumericVector out_p50 (rows);
+  NumericVector out_p99 (rows);
+  NumericVector out_iter (rows);
+  NumericVector out_max_iter (rows);
+  IntegerVector out_errors (rows);
+
+
+  if (reps < 1)
+    reps = 1;
+
+  /* time to read the clock, taken off each latency */
+  lat.resize (1001);
+  for (i = 0; i < (int) lat.size (); i++)
+  {
+    t0 = std::chrono::steady_clock::now ();
+    t1 = std::chrono::steady_clock::now ();
+    lat[i] = std::chrono::duration<double, std::nano> (t1 - t0).count ();
+  }
+  std::nth_element (lat.begin (), lat.begin () + 500, lat.end ());
+  overhead = lat[500];
+
+  r = 0;
+  for (c = 0; c < SI_MAX_CURVES; c++)
+  {
+    cu = si_curve ((short int) c);
+    code = si_spec_code[cu->sp_index];
+
+    grid.clear ();
+    i = 0;
+    for (s = 5; s <= 45; s += 5)
+      for (a = 10; a <= 150; a += 10)
+      {
+        row.age = a;
+        row.si = s;
+        row.y2bh = si_y2bh ((short int) c, s);
+        row.height[SI_AT_TOTAL] = index_to_height ((short int) c, a,
+          SI_AT_TOTAL, s, row.y2bh, 0.5);
+        row.height[SI_AT_BREAST] = index_to_height ((short int) c, a,
+          SI_AT_BREAST, s, row.y2bh, 0.5);
+        row.sitecl = si_bench_class[i % 4];
+        row.fiz = si_bench_fiz[(i / 4) % 4];
+        grid.push_back (row);
+        i++;
+      }
+    n = (int) grid.size ();
+
+    for (k = 0; k < SI_BENCH_CASES; k++)
+    {
+      bc = &si_bench_case[k];
+
+      /* throughput, after a first call for anything set up on first use */
+      sum = si_bench_call (bc, (short int) c, cu, &grid[0], code);
+      errors = 0;
+      steps = si_solver_steps;
+      t0 = std::chrono::steady_clock::now ();
+      for (p = 0; p < reps; p++)
+        for (i = 0; i < n; i++)
+          sum += si_bench_call (bc, (short int) c, cu, &grid[i], code);
+      t1 = std::chrono::steady_clock::now ();
+      steps = si_solver_steps - steps;
+
+      out_ns[r] = std::chrono::duration<double, std::nano> (t1 - t0).count () /
+        ((double) n * reps);
+      out_iter[r] = (double) steps / ((double) n * reps);
+
+      /* latency, error codes, and the most steps of any one call */
+      lat.resize ((size_t) n * reps);
+      most = 0;
+      for (p = 0; p < reps; p++)
+        for (i = 0; i < n; i++)
+        {
+          steps = si_solver_steps;
+          t0 = std::chrono::steady_clock::now ();
+          a = si_bench_call (bc, (short int) c, cu, &grid[i], code);
+          t1 = std::chrono::steady_clock::now ();
+          steps = si_solver_steps - steps;
+
+          lat[(size_t) p * n + i] = std::max (0.0,
+            std::chrono::duration<double, std::nano> (t1 - t0).count () - overhead);
+          if (steps > most)
+            most = steps;
+          if (p == 0 && a < 0 && a == (int) a)
+            errors++;
+          sum += a;
+        }
+      si_bench_sink = sum;
+
+      std::sort (lat.begin (), lat.end ());
+      out_p50[r] = lat[lat.size () / 2];
+      out_p99[r] = lat[(lat.size () * 99) / 100];
+      out_max_iter[r] = (double) most;
+
+      out_curve[r] = c;
+      out_name[r] = cu->name;
+      out_entry[r] = bc->entry;
+      out_age_type[r] = (bc->age_type < 0) ? NA_INTEGER : bc->age_type;
+      out_est_type[r] = (bc->est_type < 0) ? NA_INTEGER : bc->est_type;
+      out_calls[r] = n;
+      out_errors[r] = errors;
+      r++;
+    }
+  }
+
+  return DataFrame::create (
+    Named ("version") = out_version,
+    Named ("curve") = out_curve,
+    Named ("name") = out_name,
+    Named ("entry") = out_entry,
+    Named ("age_type") = out_age_type,
+    Named ("est_type") = out_est_type,
+    Named ("calls") = out_calls,
+    Named ("ns_per_call") = out_ns,
+    Named ("p50_ns") = out_p50,
+    Named ("p99_ns") = out_p99,
+    Named ("iterations") = out_iter,
+    Named ("max_iterations") = out_max_iter,
+    Named ("errors") = out_errors,
+    Named ("stringsAsFactors") = false);
+}
@@ -0,0 +1,704 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * sicurve.c
+ * - curve registry: a metadata lookup and batch kernel table, with one
+ *   entry per curve index, carrying the curve's capability bits,
+ *   intended species and metadata, its y2bh function, and its batch
+ *   height kernels.
+ * - batch callers resolve a curve once with si_curve(), and then call
+ *   its kernels directly.  Curves without batch kernels of their own
+ *   get generic ones, calling index_to_height() row by row.
+ * - the single-row functions are not dispatched through the registry.
+ *   index_to_height(), height_to_index(), index_to_age() and si_y2bh()
+ *   keep their own switches, so a new curve still needs its cases there,
+ *   as well as its entry in si_curve_links[], and in si_direct_list[] if
+ *   it has a direct site index equation.  The registry replaces only the
+ *   switches of Sindex_NextCurve(), Sindex_CurveSource(),
+ *   Sindex_CurveNotes() and age_to_age().
+ * - the registry is built on first use, and is read-only afterwards.
+ *
+ * 2026 oct 18 - Created.  Replaces the switch statements that were in
+ *               Sindex_NextCurve(), Sindex_CurveSource(),
+ *               Sindex_CurveNotes() and age_to_age().
+ *             - Added batch height kernels from sikernel.c.
+ *             - Added flag for direct site index equations.
+ *             - Added batch height kernels per math tier.
+ *             - Added single precision batch height kernels.
+ *             - Added si_curve_ac[], the SI_AGE_AC curves as a bitset.
+ *             - Added batch height gradient kernels, by central
+ *               differences for curves without one of their own.
+ *             - Removed the single-row function pointers, which only
+ *               called the switched functions, and guarded each curve's
+ *               entries with its #ifdef, as the other per-curve tables.
+ *             - The generic gradient kernel gives NaN derivatives, rather
+ *               than differences of index_to_height().
+ *             - si_curve_ac() returns the bitset, filled with the
+ *               registry by si_curve_build(), rather than by a static
+ *               initializer.
+ *             - Described the registry as a metadata lookup and batch
+ *               kernel table; the single-row functions do not use it.
+ *             - Removed the single precision batch height kernels.
+ */
+
+
+static const SI_CURVE *si_curve_reg (void);
+static const SI_CURVE *si_curve_build (void);
+static void si_height_n (short int, int, const double *, const int *,
+  const double *, const double *, double, double *);
+static void si_height_grad_n (short int, int, const double *, const int *,
+  const double *, const double *, double, double *, double *, double *);
+
+
+/*
+ * per curve: next curve for the same species (as walked by
+ * Sindex_NextCurve()), curve to take source text from, curve to take
+ * notes text from, and age conversion rule.
+ *
+ * Curves that were never in the Sindex_NextCurve() list point to
+ * themselves, as they did before.
+ */
+static const short int si_curve_links[SI_MAX_CURVES][4] =
+  {
+#ifdef SI_ACB_HUANG
+  { SI_ERR_NO_ANS,      SI_ACB_HUANG,       SI_ACB_HUANG,       SI_AGE_STD },
+#endif
+#ifdef SI_ACT_THROWER
+  { SI_ERR_NO_ANS,      SI_ACT_THROWER,     SI_ACT_THROWER,     SI_AGE_STD },
+#endif
+#ifdef SI_AT_HUANG
+  { SI_AT_CIESZEWSKI,   SI_ACB_HUANG,       SI_AT_HUANG,        SI_AGE_STD },
+#endif
+#ifdef SI_AT_CIESZEWSKI
+  { SI_AT_GOUDIE,       SI_AT_CIESZEWSKI,   SI_AT_CIESZEWSKI,   SI_AGE_STD },
+#endif
+#ifdef SI_AT_GOUDIE
+  { SI_ERR_NO_ANS,      SI_AT_GOUDIE,       SI_AT_GOUDIE,       SI_AGE_STD },
+#endif
+#ifdef SI_BA_DILUCCA
+  { SI_BA_KURUCZ86,     SI_BA_DILUCCA,      SI_BA_DILUCCA,      SI_AGE_STD },
+#endif
+#ifdef SI_BB_KER
+  { SI_BB_KER,          SI_BB_KER,          SI_BB_KER,          SI_AGE_STD },
+#endif
+#ifdef SI_BA_KURUCZ86
+  { SI_BA_KURUCZ82,     SI_BA_KURUCZ86,     SI_BA_KURUCZ86,     SI_AGE_STD },
+#endif
+#ifdef SI_BA_KURUCZ82
+  { SI_ERR_NO_ANS,      SI_BA_KURUCZ82,     SI_BA_KURUCZ82,     SI_AGE_STD },
+#endif
+#ifdef SI_BL_THROWERGI
+  { SI_BL_KURUCZ82,     SI_BL_THROWERGI,    SI_BL_THROWERGI,    SI_AGE_STD },
+#endif
+#ifdef SI_BL_KURUCZ82
+  { SI_ERR_NO_ANS,      SI_BA_KURUCZ82,     SI_BL_KURUCZ82,     SI_AGE_STD },
+#endif
+#ifdef SI_CWC_KURUCZ
+  { SI_CWC_BARKER,      SI_CWC_KURUCZ,      SI_CWC_KURUCZ,      SI_AGE_STD },
+#endif
+#ifdef SI_CWC_BARKER
+  { SI_ERR_NO_ANS,      SI_CWC_BARKER,      SI_CWC_BARKER,      SI_AGE_STD },
+#endif
+#ifdef SI_DR_NIGH
+  { SI_DR_HARRING,      SI_DR_NIGH,         SI_DR_NIGH,         SI_AGE_AC },
+#endif
+#ifdef SI_DR_HARRING
+  { SI_ERR_NO_ANS,      SI_DR_HARRING,      SI_DR_HARRING,      SI_AGE_STD },
+#endif
+#ifdef SI_FDC_NIGHGI
+  { SI_FDC_BRUCE,       SI_FDC_NIGHGI,      SI_FDC_NIGHGI,      SI_AGE_STD },
+#endif
+#ifdef SI_FDC_BRUCE
+  { SI_FDC_COCHRAN,     SI_FDC_BRUCE,       SI_FDC_BRUCE,       SI_AGE_STD },
+#endif
+#ifdef SI_FDC_COCHRAN
+  { SI_FDC_KING,        SI_FDC_COCHRAN,     SI_FDC_COCHRAN,     SI_AGE_STD },
+#endif
+#ifdef SI_FDC_KING
+  { SI_ERR_NO_ANS,      SI_FDC_KING,        SI_FDC_KING,        SI_AGE_STD },
+#endif
+#ifdef SI_FDI_NIGHGI
+  { SI_FDI_HUANG_PLA,   SI_FDI_NIGHGI,      SI_FDI_NIGHGI,      SI_AGE_STD },
+#endif
+#ifdef SI_FDI_HUANG_PLA
+  { SI_FDI_HUANG_NAT,   SI_ACB_HUANG,       SI_FDI_HUANG_PLA,   SI_AGE_STD },
+#endif
+#ifdef SI_FDI_HUANG_NAT
+  { SI_FDI_MILNER,      SI_ACB_HUANG,       SI_FDI_HUANG_PLA,   SI_AGE_STD },
+#endif
+#ifdef SI_FDI_MILNER
+  { SI_FDI_THROWER,     SI_FDI_MILNER,      SI_FDI_MILNER,      SI_AGE_STD },
+#endif
+#ifdef SI_FDI_THROWER
+  { SI_FDI_VDP_MONT,    SI_FDI_THROWER,     SI_FDI_THROWER,     SI_AGE_STD },
+#endif
+#ifdef SI_FDI_VDP_MONT
+  { SI_FDI_VDP_WASH,    SI_FDI_VDP_MONT,    SI_FDI_VDP_MONT,    SI_AGE_STD },
+#endif
+#ifdef SI_FDI_VDP_WASH
+  { SI_FDI_MONS_DF,     SI_FDI_VDP_MONT,    SI_FDI_VDP_MONT,    SI_AGE_STD },
+#endif
+#ifdef SI_FDI_MONS_DF
+  { SI_FDI_MONS_GF,     SI_FDI_MONS_DF,     SI_FDI_MONS_DF,     SI_AGE_STD },
+#endif
+#ifdef SI_FDI_MONS_GF
+  { SI_FDI_MONS_WRC,    SI_FDI_MONS_DF,     SI_FDI_MONS_DF,     SI_AGE_STD },
+#endif
+#ifdef SI_FDI_MONS_WRC
+  { SI_FDI_MONS_WH,     SI_FDI_MONS_DF,     SI_FDI_MONS_DF,     SI_AGE_STD },
+#endif
+#ifdef SI_FDI_MONS_WH
+  { SI_FDI_MONS_SAF,    SI_FDI_MONS_DF,     SI_FDI_MONS_DF,     SI_AGE_STD },
+#endif
+#ifdef SI_FDI_MONS_SAF
+  { SI_ERR_NO_ANS,      SI_FDI_MONS_DF,     SI_FDI_MONS_DF,     SI_AGE_STD },
+#endif
+#ifdef SI_HWC_NIGHGI
+  { SI_HWC_NIGHGI,      SI_HWC_NIGHGI,      SI_HWC_NIGHGI,      SI_AGE_STD },
+#endif
+#ifdef SI_HWC_FARR
+  { SI_HWC_BARKER,      SI_HWC_FARR,        SI_HWC_FARR,        SI_AGE_STD },
+#endif
+#ifdef SI_HWC_BARKER
+  { SI_HWC_WILEY,       SI_CWC_BARKER,      SI_HWC_BARKER,      SI_AGE_STD },
+#endif
+#ifdef SI_HWC_WILEY
+  { SI_HWC_WILEY_BC,    SI_HWC_WILEY,       SI_HWC_WILEY,       SI_AGE_STD },
+#endif
+#ifdef SI_HWC_WILEY_BC
+  { SI_HWC_WILEY_MB,    SI_HWC_WILEY,       SI_HWC_WILEY_BC,    SI_AGE_STD },
+#endif
+#ifdef SI_HWC_WILEY_MB
+  { SI_ERR_NO_ANS,      SI_HWC_WILEY,       SI_HWC_WILEY_MB,    SI_AGE_STD },
+#endif
+#ifdef SI_HWI_NIGH
+  { SI_HWI_NIGHGI,      SI_HWI_NIGH,        SI_HWI_NIGH,        SI_AGE_AC },
+#endif
+#ifdef SI_HWI_NIGHGI
+  { SI_ERR_NO_ANS,      SI_HWI_NIGHGI,      SI_HWI_NIGHGI,      SI_AGE_STD },
+#endif
+#ifdef SI_LW_MILNER
+  { SI_ERR_NO_ANS,      SI_FDI_MILNER,      SI_LW_MILNER,       SI_AGE_STD },
+#endif
+#ifdef SI_PLI_THROWNIGH
+  { SI_PLI_NIGH,        SI_PLI_THROWNIGH,   SI_PLI_THROWNIGH,   SI_AGE_AC },
+#endif
+#ifdef SI_PLI_NIGHTA98
+  { SI_PLI_NIGHGI97,    SI_PLI_NIGHTA98,    SI_PLI_NIGHTA98,    SI_AGE_AC },
+#endif
+#ifdef SI_PLI_NIGHGI97
+  { SI_PLI_HUANG_PLA,   SI_PLI_NIGHGI97,    SI_PLI_NIGHGI97,    SI_AGE_STD },
+#endif
+#ifdef SI_PLI_HUANG_PLA
+  { SI_PLI_HUANG_NAT,   SI_ACB_HUANG,       SI_PLI_HUANG_PLA,   SI_AGE_STD },
+#endif
+#ifdef SI_PLI_HUANG_NAT
+  { SI_PLI_THROWER,     SI_ACB_HUANG,       SI_PLI_HUANG_PLA,   SI_AGE_STD },
+#endif
+#ifdef SI_PLI_THROWER
+  { SI_PLI_MILNER,      SI_PLI_THROWER,     SI_PLI_THROWER,     SI_AGE_AC },
+#endif
+#ifdef SI_PLI_MILNER
+  { SI_PLI_CIESZEWSKI,  SI_FDI_MILNER,      SI_PLI_MILNER,      SI_AGE_STD },
+#endif
+#ifdef SI_PLI_CIESZEWSKI
+  { SI_PLI_GOUDIE_DRY,  SI_AT_CIESZEWSKI,   SI_PLI_CIESZEWSKI,  SI_AGE_STD },
+#endif
+#ifdef SI_PLI_GOUDIE_DRY
+  { SI_PLI_GOUDIE_WET,  SI_PLI_GOUDIE_DRY,  SI_PLI_GOUDIE_DRY,  SI_AGE_STD },
+#endif
+#ifdef SI_PLI_GOUDIE_WET
+  { SI_PLI_DEMPSTER,    SI_PLI_GOUDIE_DRY,  SI_PLI_GOUDIE_DRY,  SI_AGE_STD },
+#endif
+#ifdef SI_PLI_DEMPSTER
+  { SI_ERR_NO_ANS,      SI_AT_GOUDIE,       SI_PLI_DEMPSTER,    SI_AGE_STD },
+#endif
+#ifdef SI_PW_CURTIS
+  { SI_ERR_NO_ANS,      SI_PW_CURTIS,       SI_PW_CURTIS,       SI_AGE_STD },
+#endif
+#ifdef SI_PY_MILNER
+  { SI_PY_HANN,         SI_FDI_MILNER,      SI_PY_MILNER,       SI_AGE_STD },
+#endif
+#ifdef SI_PY_HANN
+  { SI_ERR_NO_ANS,      SI_PY_HANN,         SI_PY_HANN,         SI_AGE_STD },
+#endif
+#ifdef SI_SB_HUANG
+  { SI_SB_CIESZEWSKI,   SI_ACB_HUANG,       SI_SB_HUANG,        SI_AGE_STD },
+#endif
+#ifdef SI_SB_CIESZEWSKI
+  { SI_SB_KER,          SI_AT_CIESZEWSKI,   SI_SB_CIESZEWSKI,   SI_AGE_STD },
+#endif
+#ifdef SI_SB_KER
+  { SI_SB_DEMPSTER,     SI_SB_KER,          SI_SB_KER,          SI_AGE_STD },
+#endif
+#ifdef SI_SB_DEMPSTER
+  { SI_ERR_NO_ANS,      SI_AT_GOUDIE,       SI_SB_DEMPSTER,     SI_AGE_STD },
+#endif
+#ifdef SI_SS_NIGHGI
+  { SI_SS_NIGHGI,       SI_SS_NIGHGI,       SI_SS_NIGHGI,       SI_AGE_STD },
+#endif
+#ifdef SI_SS_NIGH
+  { SI_SS_GOUDIE,       SI_SS_NIGH,         SI_SS_NIGH,         SI_AGE_AC },
+#endif
+#ifdef SI_SS_GOUDIE
+  { SI_SS_FARR,         SI_SS_GOUDIE,       SI_SS_GOUDIE,       SI_AGE_STD },
+#endif
+#ifdef SI_SS_FARR
+  { SI_SS_BARKER,       SI_HWC_FARR,        SI_SS_FARR,         SI_AGE_STD },
+#endif
+#ifdef SI_SS_BARKER
+  { SI_ERR_NO_ANS,      SI_CWC_BARKER,      SI_SS_BARKER,       SI_AGE_STD },
+#endif
+#ifdef SI_SW_NIGHGI
+  { SI_SW_NIGHGI,       SI_SW_NIGHGI,       SI_SW_NIGHGI,       SI_AGE_STD },
+#endif
+#ifdef SI_SW_HUANG_PLA
+  { SI_SW_HUANG_NAT,    SI_ACB_HUANG,       SI_SW_HUANG_PLA,    SI_AGE_STD },
+#endif
+#ifdef SI_SW_HUANG_NAT
+  { SI_SW_THROWER,      SI_ACB_HUANG,       SI_SW_HUANG_PLA,    SI_AGE_STD },
+#endif
+#ifdef SI_SW_THROWER
+  { SI_SW_CIESZEWSKI,   SI_PLI_THROWER,     SI_SW_THROWER,      SI_AGE_STD },
+#endif
+#ifdef SI_SW_CIESZEWSKI
+  { SI_SW_KER_PLA,      SI_AT_CIESZEWSKI,   SI_SW_CIESZEWSKI,   SI_AGE_STD },
+#endif
+#ifdef SI_SW_KER_PLA
+  { SI_SW_KER_NAT,      SI_SB_KER,          SI_SW_KER_PLA,      SI_AGE_STD },
+#endif
+#ifdef SI_SW_KER_NAT
+  { SI_SW_GOUDIE_PLAAC, SI_SB_KER,          SI_SW_KER_PLA,      SI_AGE_STD },
+#endif
+#ifdef SI_SW_GOUDIE_PLA
+  { SI_SW_GOUDIE_NATAC, SI_PLI_GOUDIE_DRY,  SI_SW_GOUDIE_PLA,   SI_AGE_STD },
+#endif
+#ifdef SI_SW_GOUDIE_NAT
+  { SI_ERR_NO_ANS,      SI_PLI_GOUDIE_DRY,  SI_SW_GOUDIE_PLA,   SI_AGE_STD },
+#endif
+#ifdef SI_SW_DEMPSTER
+  { SI_SW_DEMPSTER,     SI_AT_GOUDIE,       SI_SW_DEMPSTER,     SI_AGE_STD },
+#endif
+#ifdef SI_BL_CHEN
+  { SI_BL_THROWERGI,    SI_BL_CHEN,         SI_BL_CHEN,         SI_AGE_STD },
+#endif
+#ifdef SI_AT_CHEN
+  { SI_AT_HUANG,        SI_AT_CHEN,         SI_AT_CHEN,         SI_AGE_STD },
+#endif
+#ifdef SI_DR_CHEN
+  { SI_DR_CHEN,         SI_DR_CHEN,         SI_DR_CHEN,         SI_AGE_STD },
+#endif
+#ifdef SI_PL_CHEN
+  { SI_PLI_THROWNIGH,   SI_PL_CHEN,         SI_PL_CHEN,         SI_AGE_STD },
+#endif
+#ifdef SI_CWI_NIGH
+  { SI_CWI_NIGHGI,      SI_CWI_NIGH,        SI_CWI_NIGH,        SI_AGE_AC },
+#endif
+#ifdef SI_BP_CURTIS
+  { SI_ERR_NO_ANS,      SI_BP_CURTIS,       SI_BP_CURTIS,       SI_AGE_STD },
+#endif
+#ifdef SI_HWC_NIGHGI99
+  { SI_HWC_FARR,        SI_HWC_NIGHGI99,    SI_HWC_NIGHGI99,    SI_AGE_STD },
+#endif
+#ifdef SI_SS_NIGHGI99
+  { SI_SS_NIGH,         SI_SS_NIGHGI99,     SI_SS_NIGHGI99,     SI_AGE_STD },
+#endif
+#ifdef SI_SW_NIGHGI99
+  { SI_SW_NIGHGI99,     SI_SW_NIGHGI99,     SI_SW_NIGHGI99,     SI_AGE_STD },
+#endif
+#ifdef SI_LW_NIGHGI
+  { SI_LW_MILNER,       SI_LW_NIGHGI,       SI_LW_NIGHGI,       SI_AGE_STD },
+#endif
+#ifdef SI_SW_NIGHTA
+  { SI_SW_NIGHGI2004,   SI_SW_NIGHTA,       SI_SW_NIGHTA,       SI_AGE_AC },
+#endif
+#ifdef SI_CWI_NIGHGI
+  { SI_ERR_NO_ANS,      SI_CWI_NIGH,        SI_CWI_NIGH,        SI_AGE_STD },
+#endif
+#ifdef SI_SW_GOUDNIGH
+  { SI_SW_HU_GARCIA,    SI_SW_GOUDNIGH,     SI_SW_GOUDNIGH,     SI_AGE_AC },
+#endif
+#ifdef SI_HM_MEANS
+  { SI_ERR_NO_ANS,      SI_HM_MEANS,        SI_HM_MEANS,        SI_AGE_STD },
+#endif
+#ifdef SI_SE_CHEN
+  { SI_SE_NIGHGI,       SI_SE_CHEN,         SI_SE_CHEN,         SI_AGE_STD },
+#endif
+#ifdef SI_FDC_NIGHTA
+  { SI_FDC_NIGHGI,      SI_FDC_NIGHTA,      SI_FDC_NIGHTA,      SI_AGE_AC },
+#endif
+#ifdef SI_FDC_BRUCENIGH
+  { SI_FDC_BRUCENIGH,   SI_FDC_BRUCENIGH,   SI_FDC_BRUCENIGH,   SI_AGE_AC },
+#endif
+#ifdef SI_LW_NIGH
+  { SI_LW_NIGHGI,       SI_LW_NIGH,         SI_LW_NIGH,         SI_AGE_AC },
+#endif
+#ifdef SI_SB_NIGH
+  { SI_SB_HUANG,        SI_SB_NIGH,         SI_SB_NIGH,         SI_AGE_AC },
+#endif
+#ifdef SI_AT_NIGH
+  { SI_AT_CHEN,         SI_AT_NIGH,         SI_AT_NIGH,         SI_AGE_AC },
+#endif
+#ifdef SI_BL_CHENAC
+  { SI_BL_CHEN,         SI_BL_CHENAC,       SI_BL_CHENAC,       SI_AGE_AC },
+#endif
+#ifdef SI_BP_CURTISAC
+  { SI_BP_CURTIS,       SI_BP_CURTISAC,     SI_BP_CURTISAC,     SI_AGE_AC },
+#endif
+#ifdef SI_HM_MEANSAC
+  { SI_HM_MEANS,        SI_HM_MEANSAC,      SI_HM_MEANSAC,      SI_AGE_AC },
+#endif
+#ifdef SI_FDI_THROWERAC
+  { SI_FDI_NIGHGI,      SI_FDI_THROWERAC,   SI_FDI_THROWERAC,   SI_AGE_AC },
+#endif
+#ifdef SI_ACB_HUANGAC
+  { SI_ACB_HUANG,       SI_ACB_HUANGAC,     SI_ACB_HUANGAC,     SI_AGE_AC },
+#endif
+#ifdef SI_PW_CURTISAC
+  { SI_PW_CURTIS,       SI_PW_CURTISAC,     SI_PW_CURTISAC,     SI_AGE_AC },
+#endif
+#ifdef SI_HWC_WILEYAC
+  { SI_HWC_NIGHGI99,    SI_HWC_WILEYAC,     SI_HWC_WILEYAC,     SI_AGE_AC },
+#endif
+#ifdef SI_FDC_BRUCEAC
+  { SI_FDC_NIGHTA,      SI_FDC_BRUCEAC,     SI_FDC_BRUCEAC,     SI_AGE_AC },
+#endif
+#ifdef SI_CWC_KURUCZAC
+  { SI_CWC_KURUCZ,      SI_CWC_KURUCZAC,    SI_CWC_KURUCZAC,    SI_AGE_AC },
+#endif
+#ifdef SI_BA_KURUCZ82AC
+  { SI_BA_DILUCCA,      SI_BA_KURUCZ82AC,   SI_BA_KURUCZ82AC,   SI_AGE_AC },
+#endif
+#ifdef SI_ACT_THROWERAC
+  { SI_ACT_THROWER,     SI_ACT_THROWERAC,   SI_ACT_THROWERAC,   SI_AGE_AC },
+#endif
+#ifdef SI_PY_HANNAC
+  { SI_PY_MILNER,       SI_PY_HANNAC,       SI_PY_HANNAC,       SI_AGE_AC },
+#endif
+#ifdef SI_SE_CHENAC
+  { SI_SE_CHEN,         SI_SE_CHENAC,       SI_SE_CHENAC,       SI_AGE_AC },
+#endif
+#ifdef SI_SW_GOUDIE_NATAC
+  { SI_SW_GOUDIE_NAT,   SI_SW_GOUDIE_NATAC, SI_SW_GOUDIE_NATAC, SI_AGE_AC },
+#endif
+#ifdef SI_PY_NIGH
+  { SI_PY_NIGHGI,       SI_PY_NIGH,         SI_PY_NIGH,         SI_AGE_AC },
+#endif
+#ifdef SI_PY_NIGHGI
+  { SI_PY_HANNAC,       SI_PY_NIGHGI,       SI_PY_NIGH,         SI_AGE_STD },
+#endif
+#ifdef SI_PLI_NIGHTA2004
+  { SI_PLI_NIGHTA2004,  SI_PLI_NIGHTA2004,  SI_PLI_NIGHTA2004,  SI_AGE_AC },
+#endif
+#ifdef SI_SE_NIGHTA
+  { SI_SE_NIGHTA,       SI_SE_NIGHTA,       SI_SE_NIGHTA,       SI_AGE_AC },
+#endif
+#ifdef SI_SW_NIGHTA2004
+  { SI_SW_NIGHTA2004,   SI_SW_NIGHTA2004,   SI_SW_NIGHTA2004,   SI_AGE_AC },
+#endif
+#ifdef SI_SW_GOUDIE_PLAAC
+  { SI_SW_GOUDIE_PLA,   SI_SW_GOUDIE_PLAAC, SI_SW_GOUDIE_PLAAC, SI_AGE_AC },
+#endif
+#ifdef SI_PJ_HUANG
+  { SI_PJ_HUANGAC,      SI_PJ_HUANG,        SI_PJ_HUANG,        SI_AGE_AC },
+#endif
+#ifdef SI_PJ_HUANGAC
+  { SI_ERR_NO_ANS,      SI_PJ_HUANGAC,      SI_PJ_HUANGAC,      SI_AGE_AC },
+#endif
+#ifdef SI_SW_NIGHGI2004
+  { SI_SW_HUANG_PLA,    SI_SW_NIGHGI2004,   SI_SW_NIGHGI2004,   SI_AGE_STD },
+#endif
+#ifdef SI_EP_NIGH
+  { SI_ERR_NO_ANS,      SI_EP_NIGH,         SI_EP_NIGH,         SI_AGE_AC },
+#endif
+#ifdef SI_BA_NIGHGI
+  { SI_BA_NIGH,         SI_BA_NIGHGI,       SI_BA_NIGHGI,       SI_AGE_STD },
+#endif
+#ifdef SI_BA_NIGH
+  { SI_BA_KURUCZ82AC,   SI_BA_NIGHGI,       SI_BA_NIGHGI,       SI_AGE_AC },
+#endif
+#ifdef SI_SW_HU_GARCIA
+  { SI_SW_NIGHTA,       SI_SW_HU_GARCIA,    SI_SW_HU_GARCIA,    SI_AGE_STD },
+#endif
+#ifdef SI_SE_NIGHGI
+  { SI_SE_NIGH,         SI_SE_NIGHGI,       SI_SE_NIGHGI,       SI_AGE_STD },
+#endif
+#ifdef SI_SE_NIGH
+  { SI_ERR_NO_ANS,      SI_SE_NIGH,         SI_SE_NIGH,         SI_AGE_STD },
+#endif
+#ifdef SI_CWC_NIGH
+  { SI_CWC_KURUCZAC,    SI_CWC_NIGH,        SI_CWC_NIGH,        SI_AGE_STD },
+#endif
+#ifdef SI_PLI_NIGH
+  { SI_PLI_NIGHTA98,    SI_PLI_NIGH,        SI_PLI_NIGH,        SI_AGE_STD },
+#endif
+  };
+
+
+/*
+ * the age rules of si_curve_links[] as a bitset, for si_age_to_age() to
+ * test without resolving the curve.  Filled by si_curve_build(), only.
+ */
+static unsigned int si_curve_ac_bits[SI_CURVE_WORDS];
+
+
+/*
+ * curves with a direct site index equation from breast height age,
+ * as in ba_height_to_index() in ht2si.c.  Note that ht2si.c redefines
+ * SI_AT_GOUDIE to 1 ahead of its case label, so it is SI_ACT_THROWER
+ * that takes the Goudie aspen equation there, not SI_AT_GOUDIE.
+ */
+static const short int si_direct_list[] =
+  {
+#ifdef SI_BA_DILUCCA
+  SI_BA_DILUCCA,
+#endif
+#ifdef SI_DR_NIGH
+  SI_DR_NIGH,
+#endif
+#ifdef SI_HM_MEANS
+  SI_HM_MEANS,
+#endif
+#ifdef SI_FDI_MILNER
+  SI_FDI_MILNER,
+#endif
+#ifdef SI_FDI_THROWER
+  SI_FDI_THROWER,
+#endif
+#ifdef SI_PLI_THROWER
+  SI_PLI_THROWER,
+#endif
+#ifdef SI_LW_MILNER
+  SI_LW_MILNER,
+#endif
+#ifdef SI_PLI_DEMPSTER
+  SI_PLI_DEMPSTER,
+#endif
+#ifdef SI_PLI_MILNER
+  SI_PLI_MILNER,
+#endif
+#ifdef SI_PY_MILNER
+  SI_PY_MILNER,
+#endif
+#ifdef SI_PW_CURTIS
+  SI_PW_CURTIS,
+#endif
+#ifdef SI_SW_HU_GARCIA
+  SI_SW_HU_GARCIA,
+#endif
+#ifdef SI_SW_DEMPSTER
+  SI_SW_DEMPSTER,
+#endif
+#ifdef SI_SB_DEMPSTER
+  SI_SB_DEMPSTER,
+#endif
+#ifdef SI_ACT_THROWER
+  SI_ACT_THROWER,
+#endif
+#ifdef SI_FDI_VDP_MONT
+  SI_FDI_VDP_MONT,
+#endif
+#ifdef SI_FDI_VDP_WASH
+  SI_FDI_VDP_WASH,
+#endif
+#ifdef SI_FDI_MONS_DF
+  SI_FDI_MONS_DF,
+#endif
+#ifdef SI_FDI_MONS_GF
+  SI_FDI_MONS_GF,
+#endif
+#ifdef SI_FDI_MONS_WRC
+  SI_FDI_MONS_WRC,
+#endif
+#ifdef SI_FDI_MONS_WH
+  SI_FDI_MONS_WH,
+#endif
+#ifdef SI_FDI_MONS_SAF
+  SI_FDI_MONS_SAF,
+#endif
+#ifdef SI_FDI_NIGHGI
+  SI_FDI_NIGHGI,
+#endif
+#ifdef SI_PLI_NIGHGI97
+  SI_PLI_NIGHGI97,
+#endif
+#ifdef SI_SW_NIGHGI
+  SI_SW_NIGHGI,
+#endif
+#ifdef SI_SW_NIGHGI99
+  SI_SW_NIGHGI99,
+#endif
+#ifdef SI_SW_NIGHGI2004
+  SI_SW_NIGHGI2004,
+#endif
+#ifdef SI_HWC_NIGHGI99
+  SI_HWC_NIGHGI99,
+#endif
+#ifdef SI_HWC_NIGHGI
+  SI_HWC_NIGHGI,
+#endif
+#ifdef SI_HWI_NIGHGI
+  SI_HWI_NIGHGI,
+#endif
+#ifdef SI_FDC_NIGHGI
+  SI_FDC_NIGHGI,
+#endif
+#ifdef SI_SE_NIGHGI
+  SI_SE_NIGHGI,
+#endif
+#ifdef SI_SS_NIGHGI
+  SI_SS_NIGHGI,
+#endif
+#ifdef SI_SS_NIGHGI99
+  SI_SS_NIGHGI99,
+#endif
+#ifdef SI_CWI_NIGHGI
+  SI_CWI_NIGHGI,
+#endif
+#ifdef SI_LW_NIGHGI
+  SI_LW_NIGHGI,
+#endif
+#ifdef SI_PY_NIGHGI
+  SI_PY_NIGHGI,
+#endif
+#ifdef SI_BA_NIGHGI
+  SI_BA_NIGHGI,
+#endif
+#ifdef SI_BL_THROWERGI
+  SI_BL_THROWERGI,
+#endif
+  };
+
+
+/*
+ * returns the registry entry for a curve, or NULL if out of range.
+ */
+const SI_CURVE *si_curve (short int cu_index)
+{
+  const SI_CURVE *reg = si_curve_reg ();
+
+
+  if (cu_index < 0 || cu_index >= SI_MAX_CURVES)
+    return NULL;
+
+  return &reg[cu_index];
+}
+
+
+/*
+ * returns the SI_AGE_AC bitset, one bit per curve index.
+ */
+const unsigned int *si_curve_ac (void)
+{
+  si_curve_reg ();
+  return si_curve_ac_bits;
+}
+
+
+/*
+ * the registry, built once, on first use from any thread.
+ */
+static const SI_CURVE *si_curve_reg (void)
+{
+  static const SI_CURVE *reg = si_curve_build ();
+
+
+  return reg;
+}
+
+
+static const SI_CURVE *si_curve_build (void)
+{
+  static SI_CURVE reg[SI_MAX_CURVES];
+  short int i;
+  size_t j;
+  int t;
+
+
+  for (i = 0; i < SI_MAX_CURVES; i++)
+  {
+    reg[i].cu_index = i;
+    reg[i].sp_index = Sindex_CurveToSpecies (i);
+    reg[i].next     = si_curve_links[i][0];
+    reg[i].source   = si_curve_links[i][1];
+    reg[i].notes    = si_curve_links[i][2];
+    reg[i].age_rule = (char) si_curve_links[i][3];
+    reg[i].types    = si_curve_types[i];
+    reg[i].direct   = 0;
+    reg[i].kernel   = 0;
+    reg[i].bh       = si_curve_bh[i];
+    reg[i].name     = si_curve_name[i];
+
+    reg[i].y2bh     = si_y2bh;
+    reg[i].height_n = si_height_n;
+    for (t = 0; t < SI_MATH_TIERS; t++)
+      reg[i].height_tier[t] = si_height_n;
+    reg[i].height_grad = si_height_grad_n;
+
+    if (reg[i].age_rule == SI_AGE_AC)
+      si_curve_ac_bits[i >> 5] |= 1u << (i & 31);
+  }
+
+  for (j = 0; j < sizeof (si_direct_list) / sizeof (si_direct_list[0]); j++)
+    reg[si_direct_list[j]].direct = 1;
+
+  /* curves with their own batch kernels */
+  si_kernel_install (reg);
+
+  return reg;
+}
+
+
+/*
+ * generic batch height kernel, used by curves without one of their own.
+ */
+static void si_height_n (
+  short int cu_index,
+  int n,
+  const double *age,
+  const int *age_type,
+  const double *site_index,
+  const double *y2bh,
+  double pi,
+  double *height)
+{
+  int i;
+
+
+  for (i = 0; i < n; i++)
+    height[i] = index_to_height (cu_index, age[i], (short int) age_type[i],
+      site_index[i], y2bh[i], pi);
+}
+
+
+/*
+ * generic batch height gradient kernel, used by curves without one of
+ * their own.  Heights are those of index_to_height(); derivatives are
+ * NaN, as only the kernels carry them exactly.
+ */
+static void si_height_grad_n (
+  short int cu_index,
+  int n,
+  const double *age,
+  const int *age_type,
+  const double *site_index,
+  const double *y2bh,
+  double pi,
+  double *height,
+  double *d_site,
+  double *d_age)
+{
+  int i;
+
+
+  for (i = 0; i < n; i++)
+  {
+    height[i] = index_to_height (cu_index, age[i], (short int) age_type[i],
+      site_index[i], y2bh[i], pi);
+    d_site[i] = NAN;
+    d_age[i] = NAN;
+  }
+}
@@ -0,0 +1,500 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * sifit.c
+ * - site index of plots measured more than once: the site index whose
+ *   curve passes closest, in least squares, to all of a plot's measured
+ *   heights.
+ * - each plot is solved by Gauss-Newton steps on site index, kept within
+ *   1.3 to 999 m, and to twice the last step or 1 m.  A step that does
+ *   not lower the sum of squares is halved.  Slopes are by a forward
+ *   difference of SI_FIT_DELTA, or of SI_FIT_GI_DELTA on growth intercept
+ *   curves, whose heights gi_si2ht() finds only to within 0.01 m of site
+ *   index.  Where heights do not change with site index, as below breast
+ *   height on some curves, the step is doubled in the direction of the
+ *   residuals until they do.
+ * - the fit is the nearest best from the start, the site index
+ *   height_to_index() iterates to for the measurement nearest 50 years.
+ *   On the few curves whose heights jump back at points along site index,
+ *   a better fit may lie past a jump.  A plot of one measurement has that
+ *   site index, without steps.
+ * - a fit held at 1.3 or 999 m by the slope has no answer.
+ * - plots of a curve are solved together: at each step, the heights at
+ *   every measurement of every unsolved plot, at the trial and the
+ *   difference above, go to the curve's batch kernel in one call, with
+ *   the y2bh of their site index.
+ * - a plot with a measurement height_to_index() would refuse, or that
+ *   the curve cannot reach, has that error code as its site index.  The
+ *   measurement started from has the code of height_to_index() itself.
+ *   A plot with an age or height that is not finite has NaN.
+ *
+ * 2026 oct 18 - Created.
+ *             - Starts from height_to_index() rather than from height.
+ *               Rejects ages and heights that are not finite.  A fit
+ *               held at a bound is no answer, rather than converged.
+ */
+
+
+/* site index difference for slopes */
+#define SI_FIT_DELTA    0.001
+#define SI_FIT_GI_DELTA 0.5
+
+/* most steps per plot */
+#define SI_FIT_STEPS 100
+
+/* one plot being solved */
+typedef struct
+  {
+  int    first;     /* first measurement */
+  int    count;     /* measurements */
+  double site;      /* best so far */
+  double sse;       /* its sum of squares, HUGE_VAL if none */
+  double step;      /* from site to trial */
+  double trial;
+  int    steps;
+  int    end;       /* SI_END_xxx, -1 while solving */
+  } SI_FIT_PLOT;
+
+
+static inline int si_fit_code (double h)
+{
+  return h < 0 && h == (int) h;
+}
+
+
+/*
+ * sum of squares of a plot's residuals, with their sum and, from ht_up
+ * at delta above, the sums of residual times slope and slope squared.
+ * HUGE_VAL if a height is past 999; code gets any other error code.
+ */
+static double si_fit_sse (
+  const SI_FIT_PLOT *p,
+  const double *ht,
+  const double *ht_up,
+  const double *height,
+  double delta,
+  double *sum,
+  double *rj,
+  double *jj,
+  double *code)
+{
+  double sse, r, d;
+  int i;
+
+
+  sse = 0;
+  *sum = 0;
+  *rj = 0;
+  *jj = 0;
+  *code = 0;
+  for (i = 0; i < p->count; i++)
+  {
+    if (ht[i] == SI_ERR_NO_ANS) /* height > 999 */
+      sse = HUGE_VAL;
+    else if (si_fit_code (ht[i]))
+      *code = ht[i];
+    else
+    {
+      r = ht[i] - height[p->first + i];
+      sse += r * r;
+      *sum += r;
+      d = si_fit_code (ht_up[i]) ? 0 : (ht_up[i] - ht[i]) / delta;
+      *rj += r * d;
+      *jj += d * d;
+    }
+  }
+  return sse;
+}
+
+
+/*
+ * an error code for a measurement, as from height_to_index(), or 0.  NaN
+ * if its age or height is not finite.
+ */
+static double si_fit_check (
+  short int cu_index,
+  double age,
+  int age_type,
+  double height)
+{
+  if (!isfinite (age) || !isfinite (height))
+    return NAN;
+  if (si_curve (cu_index) == NULL)
+    return SI_ERR_CURVE;
+  if (age_type == SI_AT_BREAST)
+  {
+    if (height < 1.3)
+      return SI_ERR_LT13;
+  }
+  else
+  {
+    if (height <= 0)
+      return SI_ERR_NO_ANS;
+    if (si_y2bh (cu_index, height) == SI_ERR_GI_TOT)
+      return SI_ERR_GI_TOT;
+  }
+  if (age <= 0)
+    return SI_ERR_NO_ANS;
+  return 0;
+}
+
+
+/*
+ * solves the plots of one curve together.  fit holds the plots, with
+ * trial and step set; fitted gets the heights at each plot's site index.
+ */
+static void si_fit_curve (
+  short int cu_index,
+  std::vector<SI_FIT_PLOT> &fit,
+  const double *age,
+  const int *age_type,
+  const double *height,
+  int tier,
+  double *fitted)
+{
+  const SI_CURVE *cu;
+  std::vector<double> k_age, k_si, k_y2bh, k_ht;
+  std::vector<int> k_type;
+  std::vector<int> live;
+  SI_FIT_PLOT *p;
+  int i, j, k, l, rows, busy;
+  double s, y2bh, d, rj, jj, sum, sse, code, delta;
+
+
+  cu = si_curve (cu_index);
+  delta = (cu->y2bh (cu_index, 10) == SI_ERR_GI_TOT) ?
+    SI_FIT_GI_DELTA : SI_FIT_DELTA;
+  for (l = 0; l < (int) fit.size (); l++)
+    if (fit[l].end < 0)
+      live.push_back (l);
+
+  while (!live.empty ())
+  {
+    busy = (int) live.size ();
+    si_solver_steps += busy;
+
+    /* two heights at each measurement of every live plot */
+    rows = 0;
+    for (l = 0; l < busy; l++)
+      rows += 2 * fit[live[l]].count;
+    k_age.resize (rows);
+    k_type.resize (rows);
+    k_si.resize (rows);
+    k_y2bh.resize (rows);
+    k_ht.resize (rows);
+
+    k = 0;
+    for (l = 0; l < busy; l++)
+    {
+      p = &fit[live[l]];
+      p->steps++;
+      for (j = 0; j < 2; j++)
+      {
+        s = p->trial + j * delta;
+        y2bh = cu->y2bh (cu_index, s);
+        for (i = p->first; i < p->first + p->count; i++)
+        {
+          k_age[k] = age[i];
+          k_type[k] = age_type[i];
+          k_si[k] = s;
+          k_y2bh[k] = y2bh;
+          k++;
+        }
+      }
+    }
+
+    cu->height_tier[tier] (cu_index, rows, k_age.data (), k_type.data (),
+      k_si.data (), k_y2bh.data (), 0.5, k_ht.data ());
+
+    /* advance each plot */
+    k = 0;
+    for (l = 0; l < busy; l++)
+    {
+      p = &fit[live[l]];
+
+      sse = si_fit_sse (p, &k_ht[k], &k_ht[k + p->count], height, delta,
+        &sum, &rj, &jj, &code);
+
+      if (code != 0)
+      {
+        p->site = code;
+        p->end = SI_END_ERROR;
+      }
+      else if (sse < p->sse || (sse == p->sse && jj == 0))
+      {
+        /* keep the trial, and take a Gauss-Newton step from it */
+        p->site = p->trial;
+        p->sse = sse;
+        for (i = 0; i < p->count; i++)
+          fitted[p->first + i] = k_ht[k + i];
+
+        d = std::max (1.0, 2.0 * fabs (p->step));
+        if (jj > 0)
+          s = std::min (d, std::max (-d, -rj / jj));
+        else
+          s = (sum < 0) ? d : -d;
+        p->trial = std::min (999.0, std::max (1.3, p->site + s));
+
+        /* at a bound, with the slope still pointing past it */
+        if (p->trial == p->site && (jj > 0 ? rj != 0 : sum != 0))
+        {
+          p->site = SI_ERR_NO_ANS;
+          p->end = SI_END_ERROR;
+        }
+      }
+      else
+        p->trial = p->site + (p->trial - p->site) / 2.0;
+
+      if (p->end < 0)
+      {
+        p->step = p->trial - p->site;
+        if (p->step < 0.00001 && p->step > -0.00001)
+          p->end = SI_END_CONVERGED;
+        else if (p->steps >= SI_FIT_STEPS)
+          p->end = SI_END_LIMIT;
+      }
+
+      /* no trial reached, or it is past 999 */
+      if (p->end >= 0 && p->end != SI_END_ERROR &&
+          (p->sse == HUGE_VAL || p->site >= 999.0))
+      {
+        p->site = SI_ERR_NO_ANS;
+        p->end = SI_END_ERROR;
+      }
+
+      if (p->end >= 0 && SI_TELEMETRY_ON)
+        si_telemetry_solve (SI_SOLVE_FIT, cu_index, (short int) p->end,
+          p->site, p->steps);
+      k += 2 * p->count;
+    }
+
+    /* drop the plots that are done */
+    for (l = 0, j = 0; l < busy; l++)
+      if (fit[live[l]].end < 0)
+        live[j++] = live[l];
+    live.resize (j);
+  }
+}
+
+
+/*
+ * site index of each of plots, from their measurements in order by plot.
+ * Plot p's measurements are start[p] up to start[p + 1].  fitted gets the
+ * height at the plot's site index for each measurement, or its error
+ * code.
+ */
+void si_fit_plots (
+  int plots,
+  const int *start,
+  const int *cu_index,
+  const double *age,
+  const int *age_type,
+  const double *height,
+  int tier,
+  double *site,
+  int *steps,
+  double *fitted)
+{
+  std::vector<int> group (SI_MAX_CURVES + 2);
+  std::vector<int> perm (plots);
+  std::vector<SI_FIT_PLOT> fit;
+  SI_FIT_PLOT p;
+  int g, j, i, best;
+  double code, s;
+
+
+  si_group_rows (plots, cu_index, group.data (), perm.data ());
+
+  for (g = 0; g <= SI_MAX_CURVES; g++)
+  {
+    fit.clear ();
+    for (j = group[g]; j < group[g + 1]; j++)
+    {
+      p.first = start[perm[j]];
+      p.count = start[perm[j] + 1] - p.first;
+      p.site = 1.3;
+      p.sse = HUGE_VAL;
+      p.steps = 0;
+      p.end = -1;
+
+      /*
+       * refused measurements, and the start from the one nearest 50
+       * years, as height_to_index() solves it alone
+       */
+      code = (p.count > 0) ? 0 : SI_ERR_NO_ANS;
+      best = p.first;
+      for (i = p.first; i < p.first + p.count && code == 0; i++)
+        if (!isfinite (age[i]) || !isfinite (height[i]))
+          code = NAN;
+        else if (fabs (age[i] - 50) < fabs (age[best] - 50))
+          best = i;
+      s = 0;
+      if (code == 0)
+      {
+        s = height_to_index ((short int) cu_index[perm[j]], age[best],
+          (short int) age_type[best], height[best], SI_EST_ITERATE);
+        if (si_fit_code (s))
+          code = s;
+      }
+      for (i = p.first; i < p.first + p.count && code == 0; i++)
+        if (i != best)
+          code = si_fit_check ((short int) g, age[i], age_type[i], height[i]);
+      if (code != 0)
+      {
+        p.site = code;
+        p.end = SI_END_ERROR;
+      }
+      else if (p.count == 1)
+      {
+        p.site = s;
+        p.end = SI_END_CONVERGED;
+        fitted[p.first] = index_to_height ((short int) g, age[p.first],
+          (short int) age_type[p.first], s, si_y2bh ((short int) g, s), 0.5);
+      }
+      else
+      {
+        p.trial = std::min (999.0, std::max (1.3, s));
+        p.step = p.trial / 2.0;
+      }
+      fit.push_back (p);
+    }
+
+    if (g < SI_MAX_CURVES)
+      si_fit_curve ((short int) g, fit, age, age_type, height, tier, fitted);
+
+    for (j = 0; j < (int) fit.size (); j++)
+    {
+      site[perm[group[g] + j]] = fit[j].site;
+      steps[perm[group[g] + j]] = fit[j].steps;
+      if (fit[j].end == SI_END_ERROR)
+        for (i = fit[j].first; i < fit[j].first + fit[j].count; i++)
+          fitted[i] = fit[j].site;
+    }
+  }
+}
+
+
+/*
+ * site index of plots from their measurements, a row per measurement.
+ * Rows of a plot need not be together, but must have the same curve.
+ * Plots are in order of their first row.  residual is height less the
+ * height of the curve at the fitted site index, NA for plots with an
+ * error code or an NA age or height.
+ */
+// [[Rcpp::export]]
+List Sindex_SIFit (
+    IntegerVector plot,
+    IntegerVector cu_index,
+    NumericVector age,
+    IntegerVector age_type,
+    NumericVector height,
+    int tier = 0)
+{
+  int n = plot.size ();
+  std::vector<int> order (n);
+  std::vector<int> first;
+  std::vector<int> start;
+  std::vector<int> curve;
+  std::vector<int> steps;
+  std::vector<int> g_type (n);
+  std::vector<double> g_age (n), g_height (n), g_fitted (n);
+  int i, j, k, plots;
+  double sse;
+
+
+  if (cu_index.size () != n || age.size () != n || age_type.size () != n ||
+      height.size () != n)
+    stop ("all inputs must have the same length");
+  if (tier < 0 || tier >= SI_MATH_TIERS)
+    stop ("unknown math tier");
+
+  /* rows by plot, then plots by their first row */
+  for (i = 0; i < n; i++)
+    order[i] = i;
+  std::stable_sort (order.begin (), order.end (),
+    [&plot] (int a, int b) { return plot[a] < plot[b]; });
+  for (i = 0; i < n; i++)
+    if (i == 0 || plot[order[i]] != plot[order[i - 1]])
+      first.push_back (i);
+  plots = (int) first.size ();
+  std::vector<int> by_row (plots);
+  for (j = 0; j < plots; j++)
+    by_row[j] = j;
+  std::sort (by_row.begin (), by_row.end (),
+    [&first, &order] (int a, int b) { return order[first[a]] < order[first[b]]; });
+  first.push_back (n);
+
+  std::vector<int> rows;
+  for (j = 0; j < plots; j++)
+  {
+    start.push_back ((int) rows.size ());
+    k = by_row[j];
+    curve.push_back (cu_index[order[first[k]]]);
+    for (i = first[k]; i < first[k + 1]; i++)
+    {
+      if (cu_index[order[i]] != curve[j])
+        stop ("each plot must have one curve");
+      rows.push_back (order[i]);
+    }
+  }
+  start.push_back (n);
+
+  for (i = 0; i < n; i++)
+  {
+    g_age[i] = age[rows[i]];
+    g_type[i] = age_type[rows[i]];
+    g_height[i] = height[rows[i]];
+  }
+
+  NumericVector out_site (plots);
+  steps.resize (plots);
+  si_fit_plots (plots, start.data (), curve.data (), g_age.data (),
+    g_type.data (), g_height.data (), tier, out_site.begin (), steps.data (),
+    g_fitted.data ());
+
+  IntegerVector out_plot (plots);
+  IntegerVector out_count (plots);
+  NumericVector out_rmse (plots);
+  NumericVector residual (n);
+  for (j = 0; j < plots; j++)
+  {
+    out_plot[j] = plot[rows[start[j]]];
+    out_count[j] = start[j + 1] - start[j];
+    sse = 0;
+    for (i = start[j]; i < start[j + 1]; i++)
+    {
+      if (!(out_site[j] >= 0))
+        residual[rows[i]] = NA_REAL;
+      else
+      {
+        residual[rows[i]] = g_height[i] - g_fitted[i];
+        sse += residual[rows[i]] * residual[rows[i]];
+      }
+    }
+    out_rmse[j] = !(out_site[j] >= 0) ? NA_REAL : sqrt (sse / out_count[j]);
+  }
+
+  std::vector<signed char> code (plots);
+  si_split_codes (plots, out_site.begin (), code.data (), NA_REAL);
+  for (j = 0; j < plots; j++)
+    if (isnan (out_site[j]))
+      out_site[j] = NA_REAL;
+  IntegerVector out_error (code.begin (), code.end ());
+
+  return List::create (
+    Named ("plots") = DataFrame::create (
+      Named ("plot") = out_plot,
+      Named ("curve") = IntegerVector (curve.begin (), curve.end ()),
+      Named ("site_index") = out_site,
+      Named ("error") = out_error,
+      Named ("measurements") = out_count,
+      Named ("rmse") = out_rmse,
+      Named ("steps") = IntegerVector (steps.begin (), steps.end ())),
+    Named ("residual") = residual);
+}
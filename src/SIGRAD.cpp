@@ -0,0 +1,281 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * sigrad.c
+ * - batch height and site index, each with its partial derivatives.
+ * - heights come from the curves' gradient kernels in the registry.
+ *   Curves with kernels in sikernel.c carry derivatives through the
+ *   height equation on dual numbers, so they are exact.  Other curves,
+ *   closed-form ones as well as the GI curves, have NaN derivatives.
+ *   Heights are those of index_to_height().
+ * - site index derivatives follow from the height derivatives at the
+ *   site index found, as it solves height(site, age) = height.  At total
+ *   age the solvers take years to breast height from the site index, so
+ *   its derivative, from si_y2bh_grad(), enters too.  They are the
+ *   derivatives of the inverse of index_to_height(), taken at the site
+ *   index found; where a curve's direct equation or solver does not
+ *   invert index_to_height() exactly, they are those of the inverse all
+ *   the same.
+ * - rows whose result is an error code have NaN derivatives.
+ *
+ * 2026 oct 18 - Created.
+ *             - Derivatives of curves without gradient kernels are NaN,
+ *               and that of y2bh is analytic, rather than differences.
+ *             - Curves with derivatives are those with kernels, which
+ *               now cover all species defaults but Bruce's Fdc AC.
+ */
+
+
+static int si_grad_code (double x)
+{
+  return x < 0 && x == (int) x;
+}
+
+
+void si_height_grad_batch (
+  int n,
+  const int *cu_index,
+  const double *age,
+  const int *age_type,
+  const double *site_index,
+  const double *y2bh,
+  double pi,
+  double *height,
+  double *d_site,
+  double *d_age)
+{
+  std::vector<int> start (SI_MAX_CURVES + 2);
+  std::vector<int> perm (n);
+  std::vector<double> g_age, g_si, g_y2bh, g_ht, g_ds, g_da;
+  std::vector<int> g_type;
+  int g, i, j, m;
+
+
+  si_group_rows (n, cu_index, start.data (), perm.data ());
+
+  for (g = 0; g < SI_MAX_CURVES; g++)
+  {
+    m = start[g + 1] - start[g];
+    if (m == 0)
+      continue;
+
+    g_age.resize (m);
+    g_type.resize (m);
+    g_si.resize (m);
+    g_y2bh.resize (m);
+    g_ht.resize (m);
+    g_ds.resize (m);
+    g_da.resize (m);
+    for (j = 0; j < m; j++)
+    {
+      i = perm[start[g] + j];
+      g_age[j] = age[i];
+      g_type[j] = age_type[i];
+      g_si[j] = site_index[i];
+      g_y2bh[j] = y2bh[i];
+    }
+
+    si_curve ((short int) g)->height_grad ((short int) g, m, g_age.data (),
+      g_type.data (), g_si.data (), g_y2bh.data (), pi, g_ht.data (),
+      g_ds.data (), g_da.data ());
+
+    for (j = 0; j < m; j++)
+    {
+      i = perm[start[g] + j];
+      height[i] = g_ht[j];
+      d_site[i] = g_ds[j];
+      d_age[i] = g_da[j];
+    }
+  }
+
+  /* unknown curves, error codes as from index_to_height() */
+  for (j = start[SI_MAX_CURVES]; j < start[SI_MAX_CURVES + 1]; j++)
+  {
+    i = perm[j];
+    height[i] = index_to_height ((short int) cu_index[i], age[i],
+      (short int) age_type[i], site_index[i], y2bh[i], pi);
+  }
+
+  for (i = 0; i < n; i++)
+    if (si_grad_code (height[i]) || isnan (height[i]))
+    {
+      d_site[i] = NAN;
+      d_age[i] = NAN;
+    }
+}
+
+
+void si_index_grad_batch (
+  int n,
+  const int *cu_index,
+  const double *age,
+  const int *age_type,
+  const double *height,
+  const int *est_type,
+  int tier,
+  double *site_index,
+  double *d_height,
+  double *d_age)
+{
+  std::vector<int> row, g_cu, g_type;
+  std::vector<double> g_age, g_si, g_y2bh, dy, g_ht, g_ds, g_da;
+  const SI_CURVE *cu;
+  short int c;
+  double y, denom;
+  int i, j, m;
+
+
+  si_index_batch (n, cu_index, age, age_type, height, est_type, tier,
+    site_index);
+
+  /* the heights at each answer, as the solvers evaluate them */
+  for (i = 0; i < n; i++)
+  {
+    d_height[i] = NAN;
+    d_age[i] = NAN;
+    if (si_grad_code (site_index[i]) || isnan (site_index[i]))
+      continue;
+
+    c = (short int) cu_index[i];
+    cu = si_curve (c);
+    y = cu->y2bh (c, site_index[i]);
+    row.push_back (i);
+    g_cu.push_back (c);
+    g_type.push_back (SI_AT_BREAST);
+    g_si.push_back (site_index[i]);
+    g_y2bh.push_back (y);
+    if (age_type[i] == SI_AT_TOTAL)
+    {
+      g_age.push_back (si_age_to_age (c, age[i], SI_AT_TOTAL, SI_AT_BREAST, y));
+      dy.push_back (si_y2bh_grad (c, site_index[i]));
+    }
+    else
+    {
+      g_age.push_back (age[i]);
+      dy.push_back (0);
+    }
+  }
+
+  m = (int) row.size ();
+  g_ht.resize (m);
+  g_ds.resize (m);
+  g_da.resize (m);
+  si_height_grad_batch (m, g_cu.data (), g_age.data (), g_type.data (),
+    g_si.data (), g_y2bh.data (), 0.5, g_ht.data (), g_ds.data (),
+    g_da.data ());
+
+  /* breast height age falls by y2bh as site index rises */
+  for (j = 0; j < m; j++)
+  {
+    denom = g_ds[j] - g_da[j] * dy[j];
+    if (denom != 0 && !isnan (denom))
+    {
+      d_height[row[j]] = 1 / denom;
+      d_age[row[j]] = -g_da[j] / denom;
+    }
+  }
+}
+
+
+/*
+ * batch height from age and site index, as Sindex_AgeSIToHtBatch(), with
+ * its derivatives by site index and age.  Heights that are error codes
+ * are NA, with the code in error.
+ */
+// [[Rcpp::export]]
+DataFrame Sindex_AgeSIToHtGrad (
+    IntegerVector cu_index,
+    NumericVector age,
+    IntegerVector age_type,
+    NumericVector site_index,
+    NumericVector y2bh,
+    double pi)
+{
+  int n = cu_index.size ();
+  int i;
+
+
+  if (age.size () != n || age_type.size () != n ||
+      site_index.size () != n || y2bh.size () != n)
+    stop ("all inputs must have the same length");
+
+  NumericVector height (n);
+  NumericVector d_site (n);
+  NumericVector d_age (n);
+  std::vector<signed char> code (n);
+  si_height_grad_batch (n, cu_index.begin (), age.begin (), age_type.begin (),
+    site_index.begin (), y2bh.begin (), pi, height.begin (), d_site.begin (),
+    d_age.begin ());
+  si_split_codes (n, height.begin (), code.data (), NA_REAL);
+
+  IntegerVector error (n);
+  for (i = 0; i < n; i++)
+  {
+    error[i] = code[i];
+    if (isnan (d_site[i]))
+      d_site[i] = NA_REAL;
+    if (isnan (d_age[i]))
+      d_age[i] = NA_REAL;
+  }
+
+  return DataFrame::create (
+    Named ("height") = height,
+    Named ("error") = error,
+    Named ("d_site_index") = d_site,
+    Named ("d_age") = d_age);
+}
+
+
+/*
+ * batch site index from height and age, as Sindex_HtAgeToSIBatch(),
+ * with its derivatives by height and age.
+ */
+// [[Rcpp::export]]
+DataFrame Sindex_HtAgeToSIGrad (
+    IntegerVector cu_index,
+    NumericVector age,
+    IntegerVector age_type,
+    NumericVector height,
+    IntegerVector est_type,
+    int tier = 0)
+{
+  int n = cu_index.size ();
+  int i;
+
+
+  if (age.size () != n || age_type.size () != n ||
+      height.size () != n || est_type.size () != n)
+    stop ("all inputs must have the same length");
+  if (tier < 0 || tier >= SI_MATH_TIERS)
+    stop ("unknown math tier");
+
+  NumericVector site (n);
+  NumericVector d_height (n);
+  NumericVector d_age (n);
+  std::vector<signed char> code (n);
+  si_index_grad_batch (n, cu_index.begin (), age.begin (), age_type.begin (),
+    height.begin (), est_type.begin (), tier, site.begin (),
+    d_height.begin (), d_age.begin ());
+  si_split_codes (n, site.begin (), code.data (), NA_REAL);
+
+  IntegerVector error (n);
+  for (i = 0; i < n; i++)
+  {
+    error[i] = code[i];
+    if (isnan (d_height[i]))
+      d_height[i] = NA_REAL;
+    if (isnan (d_age[i]))
+      d_age[i] = NA_REAL;
+  }
+
+  return DataFrame::create (
+    Named ("site_index") = site,
+    Named ("error") = error,
+    Named ("d_height") = d_height,
+    Named ("d_age") = d_age);
+}
@@ -0,0 +1,298 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * sigrow.c
+ * - height growth of stands from their current ages, for linking to
+ *   growth and yield models.
+ * - the increment over a step of years is height at age plus step less
+ *   height at age, both at the same math tier.  Rows of curves with
+ *   kernels (sikernel.c) are gathered in blocks for two batch calls;
+ *   other curves are index_to_height() at every tier, and take both ends
+ *   row by row.  The rate of growth, dheight/dage, comes from the
+ *   gradient kernels, so only curves with kernels have one.
+ * - projection over many steps is a yield table of each stand from its
+ *   own age, by si_yield_table(): every step of a block of stands is
+ *   handed to the curve's kernel in one call.  Heights are evaluated on
+ *   the curve at each step rather than summed from increments, so they
+ *   do not drift from it.
+ * - heights, and the error codes of rows without them, are those of
+ *   index_to_height().
+ *
+ * 2026 oct 18 - Created.
+ *             - Heights at both ends of the step at the tier asked for,
+ *               gathered in blocks rather than n-row copies, and rates
+ *               only from the curves' own gradient kernels.  Rates are
+ *               optional.
+ */
+
+
+static int si_grow_code (double x)
+{
+  return x < 0 && x == (int) x;
+}
+
+
+/* rows of curves with kernels gathered at a time */
+#define SI_GROW_ROWS 256
+
+/* gathered rows: row number, and the inputs of each */
+typedef struct
+  {
+  int    m;
+  int    row[SI_GROW_ROWS];
+  int    cu_index[SI_GROW_ROWS];
+  int    age_type[SI_GROW_ROWS];
+  double age[SI_GROW_ROWS];
+  double later[SI_GROW_ROWS];
+  double site_index[SI_GROW_ROWS];
+  double y2bh[SI_GROW_ROWS];
+  } SI_GROW_ROWS_BUF;
+
+
+/*
+ * heights at both ends, and rates, of gathered rows.  The gradient
+ * kernels' heights are those of the exact tier, so there they stand
+ * for the first batch call.
+ */
+static void si_grow_flush (
+  SI_GROW_ROWS_BUF *g,
+  double pi,
+  int tier,
+  double *height,
+  double *increment,
+  double *rate)
+{
+  double ht[SI_GROW_ROWS], end[SI_GROW_ROWS];
+  double d_site[SI_GROW_ROWS], d_age[SI_GROW_ROWS];
+  int i, j;
+
+
+  if (rate != NULL)
+    si_height_grad_batch (g->m, g->cu_index, g->age, g->age_type,
+      g->site_index, g->y2bh, pi, ht, d_site, d_age);
+  if (rate == NULL || tier != SI_MATH_EXACT)
+    si_height_batch (g->m, g->cu_index, g->age, g->age_type, g->site_index,
+      g->y2bh, pi, tier, ht);
+  si_height_batch (g->m, g->cu_index, g->later, g->age_type, g->site_index,
+    g->y2bh, pi, tier, end);
+
+  for (j = 0; j < g->m; j++)
+  {
+    i = g->row[j];
+    height[i] = ht[j];
+    if (si_grow_code (ht[j]))
+      increment[i] = ht[j];
+    else
+      increment[i] = si_grow_code (end[j]) ? end[j] : end[j] - ht[j];
+    if (rate != NULL)
+      rate[i] = d_age[j];
+  }
+  g->m = 0;
+}
+
+
+/*
+ * height of each row at its age, the increment to age plus step, and the
+ * rate of growth at age.  An increment is the error code of either
+ * height, if one is.  Rates are NaN where height is an error code, or
+ * the curve has no gradient kernel.  rate may be NULL.
+ */
+void si_increment_batch (
+  int n,
+  const int *cu_index,
+  const double *age,
+  const int *age_type,
+  const double *site_index,
+  const double *y2bh,
+  double pi,
+  double step,
+  int tier,
+  double *height,
+  double *increment,
+  double *rate)
+{
+  SI_GROW_ROWS_BUF g;
+  const SI_CURVE *cu;
+  short int c, type;
+  double end;
+  int i, m, last, kernel;
+
+
+  /*
+   * curves without kernels have index_to_height() at every tier, so
+   * both ends are taken row by row; the others are gathered
+   */
+  g.m = 0;
+  last = -1;
+  kernel = 0;
+  for (i = 0; i < n; i++)
+  {
+    c = (short int) cu_index[i];
+    if (cu_index[i] != last)
+    {
+      cu = si_curve (c);
+      kernel = cu != NULL && cu->kernel;
+      last = cu_index[i];
+    }
+    if (kernel)
+    {
+      m = g.m++;
+      g.row[m] = i;
+      g.cu_index[m] = cu_index[i];
+      g.age_type[m] = age_type[i];
+      g.age[m] = age[i];
+      g.later[m] = age[i] + step;
+      g.site_index[m] = site_index[i];
+      g.y2bh[m] = y2bh[i];
+      if (g.m == SI_GROW_ROWS)
+        si_grow_flush (&g, pi, tier, height, increment, rate);
+      continue;
+    }
+
+    type = (short int) age_type[i];
+    height[i] = index_to_height (c, age[i], type, site_index[i], y2bh[i], pi);
+    if (si_grow_code (height[i]))
+      increment[i] = height[i];
+    else
+    {
+      end = index_to_height (c, age[i] + step, type, site_index[i], y2bh[i],
+        pi);
+      increment[i] = si_grow_code (end) ? end : end - height[i];
+    }
+    if (rate != NULL)
+      rate[i] = NAN;
+  }
+  if (g.m > 0)
+    si_grow_flush (&g, pi, tier, height, increment, rate);
+}
+
+
+/*
+ * batch height, its increment over step years, and its rate of growth,
+ * unless rate is false.  Values that are error codes are NA, with the
+ * code in error.
+ */
+// [[Rcpp::export]]
+DataFrame Sindex_HeightIncrement (
+    IntegerVector cu_index,
+    NumericVector age,
+    IntegerVector age_type,
+    NumericVector site_index,
+    NumericVector y2bh,
+    double pi,
+    double step = 1,
+    int tier = 0,
+    bool rate = true)
+{
+  int n = cu_index.size ();
+  int i;
+
+
+  if (age.size () != n || age_type.size () != n ||
+      site_index.size () != n || y2bh.size () != n)
+    stop ("all inputs must have the same length");
+  if (tier < 0 || tier >= SI_MATH_TIERS)
+    stop ("unknown math tier");
+
+  NumericVector height (n);
+  NumericVector increment (n);
+  NumericVector growth (n, NA_REAL);
+  std::vector<signed char> code (n);
+  std::vector<signed char> inc_code (n);
+  si_increment_batch (n, cu_index.begin (), age.begin (), age_type.begin (),
+    site_index.begin (), y2bh.begin (), pi, step, tier, height.begin (),
+    increment.begin (), rate ? growth.begin () : NULL);
+  si_split_codes (n, height.begin (), code.data (), NA_REAL);
+  si_split_codes (n, increment.begin (), inc_code.data (), NA_REAL);
+
+  /* the code of height at age, else of height at the end of the step */
+  IntegerVector error (n);
+  for (i = 0; i < n; i++)
+  {
+    error[i] = (code[i] != 0) ? code[i] : inc_code[i];
+    if (isnan (growth[i]))
+      growth[i] = NA_REAL;
+  }
+
+  return DataFrame::create (
+    Named ("height") = height,
+    Named ("increment") = increment,
+    Named ("rate") = growth,
+    Named ("error") = error);
+}
+
+
+/*
+ * heights of stands projected from their ages, at each of steps steps
+ * of step years, as matrices of a row per stand and a column per step,
+ * the first at the stand's age.  increment has the growth over each
+ * step.  threads of 0 or less uses every core.
+ */
+// [[Rcpp::export]]
+List Sindex_HeightProject (
+    IntegerVector cu_index,
+    NumericVector age,
+    int age_type,
+    NumericVector site_index,
+    NumericVector y2bh,
+    double pi,
+    int steps,
+    double step = 1,
+    int tier = 0,
+    int threads = 0)
+{
+  int n = cu_index.size ();
+  int m, i, j;
+  size_t cells, c;
+
+
+  if (age.size () != n || site_index.size () != n || y2bh.size () != n)
+    stop ("all inputs must have the same length");
+  if (age_type != SI_AT_TOTAL && age_type != SI_AT_BREAST)
+    stop ("unknown age type");
+  if (steps < 0)
+    stop ("steps must not be negative");
+  if (tier < 0 || tier >= SI_MATH_TIERS)
+    stop ("unknown math tier");
+
+  m = steps + 1;
+  cells = (size_t) n * m;
+  std::vector<double> years (m);
+  for (j = 0; j < m; j++)
+    years[j] = j * step;
+
+  NumericMatrix height (n, m);
+  NumericMatrix total_age (n, m);
+  NumericMatrix breast_age (n, m);
+  si_yield_table (n, cu_index.begin (), site_index.begin (), y2bh.begin (),
+    m, years.data (), age.begin (), age_type, pi, tier, threads,
+    height.begin (), total_age.begin (), breast_age.begin ());
+
+  /* growth over each step, where both ends have heights */
+  NumericMatrix increment (n, steps);
+  for (j = 0; j < steps; j++)
+    for (i = 0; i < n; i++)
+    {
+      c = (size_t) j * n + i;
+      increment[c] = (si_grow_code (height[c]) || si_grow_code (height[c + n])) ?
+        NA_REAL : height[c + n] - height[c];
+    }
+
+  std::vector<signed char> code (cells);
+  si_split_codes ((int) cells, height.begin (), code.data (), NA_REAL);
+  IntegerMatrix error (n, m);
+  for (c = 0; c < cells; c++)
+    error[c] = code[c];
+
+  return List::create (
+    Named ("height") = height,
+    Named ("error") = error,
+    Named ("increment") = increment,
+    Named ("total_age") = total_age,
+    Named ("breast_age") = breast_age);
+}
@@ -0,0 +1,1338 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "sindex.h"
+#include "simath.h"
+using namespace Rcpp;
+
+/*
+ * sikernel.c
+ * - batch height kernels for curves with closed-form height equations.
+ * - each kernel is generated from a curve-traits template holding the
+ *   curve's coefficients, its age conversion rule, the breast height
+ *   age below which its approach to breast height is used, and that
+ *   approach.
+ * - the kernels give the same results as index_to_height(), including
+ *   its error codes; they just avoid the curve switch and per-call setup
+ *   for every row.
+ * - each kernel is also built on the dual numbers of simath.h, giving
+ *   the partial derivatives of height by site index and age along with
+ *   heights equal to the exact tier's.
+ * - kernels are installed into the curve registry by si_kernel_install().
+ * - on x86-64 with GCC or clang, each kernel is also built for AVX2 and
+ *   AVX-512, and si_kernel_install() picks the widest one the CPU (and
+ *   OS) supports.  The baseline build is SSE2 on x86-64 and NEON on
+ *   arm64, so every host can run it.
+ *
+ * 2026 oct 18 - Created, with kernels for the Goudie family, Nigh's
+ *               logistic Ss/Ep/Cwi/Hwi, and Cieszewski & Bella.
+ *             - Added AVX2 and AVX-512 builds of the kernels, chosen at
+ *               run time.  SINDEX_KERNEL_ISA can lower the choice.
+ *             - Kernels are built for each math tier of simath.h, and
+ *               vectorised where the tier allows.  Added
+ *               Sindex_MathTierReport().
+ *             - Added single precision kernels, using si_math_f.
+ *             - Added gradient kernels, using si_math_dual.
+ *             - Checks are branches for math classes that do not
+ *               vectorise, so rows below breast height skip the curve.
+ *               Site index is logged once per row.
+ *             - Added kernels for the Nigh curves that are species
+ *               defaults: Sb, At, Py, Ba, Cwc, Dr, Lw and Se.  Added the
+ *               approach to breast height to the traits.
+ *             - Removed the single precision kernels.
+ *             - Added kernels for the other species defaults but Bruce's
+ *               Fdc AC: Chen's Bl, Thrower's Fdi, Act and Pli, Goudie's
+ *               Sw AC, Curtis' Bp and Pw, Means' Hm, Huang's Acb and Pj
+ *               and Wiley's Hwc.  Forms are given the terms of pi.
+ */
+
+
+/*
+ * instruction set levels.  SI_NO_DISPATCH turns off the extra builds.
+ * AVX-512 brings FMA with it, so contraction of a*b+c is turned off in
+ * the extra builds; results then do not depend on the level.
+ */
+#define SI_ISA_BASE    0
+#define SI_ISA_AVX2    1
+#define SI_ISA_AVX512  2
+
+/*
+ * kernel loops are vectorised where the math tier allows; GCC needs
+ * trapping math and errno off for that, which does not change results.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define SI_VEC_OPTS "no-trapping-math", "no-math-errno", "tree-vectorize", "vect-cost-model=cheap"
+#define SI_VECTORISE __attribute__ ((optimize (SI_VEC_OPTS)))
+#else
+#define SI_VECTORISE
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(SI_NO_DISPATCH)
+#define SI_DISPATCH 1
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#define SI_TARGET(isa) __attribute__ ((target (isa)))
+#else
+#define SI_TARGET(isa) \
+  __attribute__ ((target (isa), optimize (SI_VEC_OPTS, "fp-contract=off")))
+#endif
+#define SI_INLINE inline __attribute__ ((always_inline))
+#else
+#define SI_INLINE inline
+#endif
+
+static int si_isa = SI_ISA_BASE;
+
+static const char *const si_isa_name[] =
+  {
+#if defined(__x86_64__)
+  "sse2",
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+  "neon",
+#else
+  "default",
+#endif
+  "avx2",
+  "avx512f"
+  };
+
+
+/*
+ * curve forms.  each computes height at or above breast height, given
+ * the traits of one curve, with the math functions of class M and in
+ * its floating type.  unit() gives the terms of a site index that do not
+ * depend on age, up to SI_FORM_TERMS of them, and height() the rest, so
+ * rows of one site index can share them.  The split is only of common
+ * terms, so heights are those of the equation as written.  Both are given
+ * the terms of pi from pi_terms(), worked out once for all rows; only the
+ * curves with ages from pi use them.
+ */
+
+#define SI_FORM_TERMS 5
+#define SI_PI_TERMS   2
+
+/* pi alone, for forms that have no terms of their own */
+struct si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void pi_terms (typename M::real pi, typename M::real *p)
+  {
+    p[0] = pi;
+    p[1] = 0;
+  }
+};
+
+/* Goudie's height-age form, also used by Dempster and Thrower's Fdi */
+struct si_goudie_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+
+    k[0] = (R) C::x2 + (R) C::x1 * si_llog<M> (site_index - (R) 1.3);
+    k[1] = (R) 1.0 + M::exp (k[0] + (R) C::x3 * M::log ((R) 50.0));
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real site_index, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+    R x1;
+
+    x1 = k[1] / ((R) 1.0 + M::exp (k[0] + (R) C::x3 * M::log (bhage)));
+
+    return (R) 1.3 + (site_index - (R) 1.3) * x1;
+  }
+};
+
+/* Nigh's logistic form, origin corrected to bhage 0.5 */
+struct si_nigh_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+
+    k[0] = (R) C::x3 * si_llog<M> (site_index - (R) 1.3);
+    k[1] = (R) 1.0 + M::exp ((R) C::x1 + (R) C::x2 * M::log ((R) 49.5) + k[0]);
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real site_index, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+    R x1;
+
+    x1 = k[1] / ((R) 1.0 + M::exp ((R) C::x1 + (R) C::x2 * M::log (bhage-(R) 0.5) + k[0]));
+
+    return (R) 1.3 + (site_index - (R) 1.3) * x1;
+  }
+};
+
+/* Cieszewski & Bella's form */
+struct si_cieszewski_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+    const R x1 = (R) C::x1, x2 = (R) C::x2;
+
+    k[0] = 20 * x2 / (M::pow ((R) 50.0, 1+x1));
+    k[1] = site_index-(R) 1.3 +
+      M::sqrt ((site_index-(R) 1.3 - k[0])*(site_index-(R) 1.3 - k[0]) +
+      80*x2*(site_index-(R) 1.3) * M::pow ((R) 50.0, -(1+x1)));
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+    const R x1 = (R) C::x1, x2 = (R) C::x2;
+
+    return (R) 1.3 + (k[1] + k[0]) /
+      (2 + 80*x2*M::pow (bhage, -(1+x1)) / (k[1] - k[0]));
+  }
+};
+
+/* Nigh's logistic form with log of site index, as his Sb and At */
+struct si_nigh_log_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+
+    k[0] = (R) C::x3 * M::log (site_index - (R) 1.3);
+    k[1] = (site_index - (R) 1.3) *
+      (1 + M::exp ((R) C::x1 + (R) C::x2 * M::log ((R) 49.5) + k[0]));
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+
+    return (R) 1.3 + k[1] /
+      (1 + M::exp ((R) C::x1 + (R) C::x2 * M::log (bhage-(R) 0.5) + k[0]));
+  }
+};
+
+/* Nigh's Ba */
+struct si_ba_nigh_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+    R x5;
+
+    x5 = M::pow (site_index - (R) 1.3, (R) 3.0) / (R) 49.5;
+    k[0] = x5 + M::pow (x5 * x5 + (R) 16692000.0 * M::pow (site_index - (R) 1.3, (R) 3.0) / (R) 299891.0, (R) 0.5);
+    k[1] = (R) 8346000.0 + k[0] * (R) 6058.412;
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real site_index, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+    R x2, x3;
+
+    x2 = k[1] * M::pow (bhage-(R) 0.5, (R) 3.232);
+    x3 = ((R) 8346000.0 + k[0] * M::pow (bhage-(R) 0.5, (R) 2.232)) * (R) 299891.0;
+
+    return (R) 1.3 + (site_index - (R) 1.3) * M::pow (x2 / x3, (R) (1/3.0));
+  }
+};
+
+/* Nigh's Cwc */
+struct si_cwc_nigh_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+
+    k[0] = (R) -3.004284755 + (R) 2.5332489439 * site_index - (R) 0.019027688 * site_index * site_index + (R) 0.0000992968 * M::pow (site_index, (R) 3.0);
+    k[1] = (R) 1.4026 - (R) 0.005781 * k[0];
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+
+    return (R) 1.3 + k[0] * M::pow (1 - M::exp ((R) -0.01449 * (bhage-(R) 0.5)), k[1]);
+  }
+};
+
+/* Nigh & Courtin's Dr */
+struct si_dr_nigh_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+    R si25;
+
+    si25 = (R) 0.3094 + (R) 0.7616 * site_index;
+    k[0] = (R) 1.693 * (si25 - (R) 1.3);
+    k[1] = 0;
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+
+    return (R) 1.3 + k[0] /
+      (1 + M::exp ((R) 3.6 - (R) 1.24 * M::log (bhage - (R) 0.5)));
+  }
+};
+
+/* Nigh's Lw */
+struct si_lw_nigh_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+
+    k[0] = M::log (M::pow (site_index - (R) 1.3, (R) (1 - 0.8566)) / (R) 3.027) /
+      M::log (1 - M::exp ((R) (-0.01588 * 49.5)));
+    k[1] = (R) 3.027 * M::pow (site_index - (R) 1.3, (R) 0.8566);
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+
+    return (R) 1.3 + k[1] *
+      M::pow (1 - M::exp ((R) -0.01588 * (bhage - (R) 0.5)), k[0]);
+  }
+};
+
+/*
+ * Nigh's Se.  The square is a product in the polynomial tiers, whose pow
+ * is for x > 0 only.
+ */
+struct si_se_nigh_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+    R x1, l;
+
+    l = M::log (site_index - (R) 1.3) - (R) 1.71635;
+    x1 = (R) 0.5 * (l + M::sqrt ((M::branch_free ? l * l : M::pow (l, (R) 2.0)) + (R) 45.3824));
+    k[0] = M::exp (x1);
+    k[1] = (R) -1.758 + (R) 11.6209 / x1;
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+
+    return (R) 1.3 + k[0] * M::pow (1 - M::exp ((R) -0.00955 * (bhage-(R) 0.5)), k[1]);
+  }
+};
+
+/* Goudie's form with ages from 0.5, as Thrower's Fdi and Act AC curves */
+struct si_goudie_ac_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+
+    k[0] = (R) C::x2 + (R) C::x1 * si_llog<M> (site_index - (R) 1.3);
+    k[1] = (R) 1.0 + M::exp (k[0] + (R) C::x3 * M::log ((R) 49.5));
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real site_index, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+    R x1;
+
+    x1 = k[1] / ((R) 1.0 + M::exp (k[0] + (R) C::x3 * M::log (bhage - (R) 0.5)));
+
+    return (R) 1.3 + (site_index - (R) 1.3) * x1;
+  }
+};
+
+/* Goudie's form with ages from pi, as Thrower's Pli and Goudie's Sw AC */
+struct si_goudie_pi_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void pi_terms (typename M::real pi, typename M::real *p)
+  {
+    typedef typename M::real R;
+
+    p[0] = pi;
+    p[1] = M::log ((R) 50 - pi);
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *p, typename M::real *k)
+  {
+    typedef typename M::real R;
+
+    k[0] = (R) C::x2 + (R) C::x1 * si_llog<M> (site_index - (R) 1.3);
+    k[1] = (R) 1.0 + M::exp (k[0] + (R) C::x3 * p[1]);
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real site_index, typename M::real bhage, const typename M::real *p)
+  {
+    typedef typename M::real R;
+    R x1;
+
+    x1 = k[1] / ((R) 1.0 + M::exp (k[0] + (R) C::x3 * M::log (bhage - p[0])));
+
+    return (R) 1.3 + (site_index - (R) 1.3) * x1;
+  }
+};
+
+/*
+ * Curtis' Bp AC, in feet.  The squares are products in the polynomial
+ * tiers, as for Se.
+ */
+struct si_bp_curtis_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+
+    k[0] = M::log (site_index / (R) 0.3048 - (R) 4.5);
+    k[1] = 0;
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+    R l, l2, x1, x2;
+
+    l = M::log (bhage - (R) 0.5) - M::log ((R) 49.5);
+    l2 = M::branch_free ? l * l : M::pow (l, (R) 2.0);
+    x1 = k[0] + (R) 1.649871 * l + (R) 0.147245 * l2;
+    x2 = (R) 1.0 + (R) 0.164927 * l + (R) 0.052467 * l2;
+
+    return ((R) 4.5 + M::exp (x1 / x2)) * (R) 0.3048;
+  }
+};
+
+/* Curtis' Pw AC, in feet */
+struct si_pw_curtis_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+
+    k[0] = (R) 1.119438 * M::log (site_index / (R) 0.3048);
+    k[1] = site_index / (R) 0.3048 - (R) 4.5;
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+    R lb, x1, x2;
+
+    lb = M::log (bhage - (R) 0.5);
+    x1 = (R) 1.0 - M::exp (-M::exp ((R) -9.975053 + (R) (1.747353 - 0.38583) * lb + k[0]));
+    x2 = (R) 1.0 - M::exp (-M::exp ((R) -9.975053 + (R) 1.747353 * M::log ((R) 49.5) -
+      (R) 0.38583 * lb + k[0]));
+
+    return ((R) 4.5 + k[1] * x1 / x2) * (R) 0.3048;
+  }
+};
+
+/* Means' Hm AC, by his base 100 site index */
+struct si_hm_means_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+    R s;
+
+    s = (R) -1.73 + (R) 3.149 * si_ppow<M> (site_index, (R) 0.8279);
+    k[0] = (R) 22.87 + (R) 0.9502 * (s - (R) 1.37);
+    k[1] = (R) -0.0020647 * si_ppow<M> (s - (R) 1.37, (R) 0.5);
+    k[2] = (R) 1.3656 + (R) 2.046 / (s - (R) 1.37);
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+
+    return (R) 1.37 + k[0] *
+      si_ppow<M> (1 - M::exp (k[1] * (bhage - (R) 0.5)), k[2]);
+  }
+};
+
+/* Huang's Acb AC */
+struct si_acb_huang_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+
+    k[0] = (R) -0.041208 * si_ppow<M> (site_index - (R) 1.3, (R) -0.559626) *
+      M::pow ((R) 1.038923, site_index - (R) 1.3);
+    k[1] = 1 - M::exp (k[0] * (R) 49.5);
+    k[2] = (R) 0.832609 * si_ppow<M> (site_index - (R) 1.3, (R) -0.627227) *
+      M::pow ((R) 49.5, (R) 0.526901);
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real site_index, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+    R x0;
+
+    x0 = ((R) 1.0 - M::exp (k[0] * (bhage - (R) 0.5))) / k[1];
+
+    /* at site index 1.3, x0 is 0/0, and pow() takes it to the 0 as 1 */
+    return (R) 1.3 + (site_index - (R) 1.3) *
+      ((k[2] == 0) ? (R) 1 : si_ppow<M> (x0, k[2]));
+  }
+};
+
+/* Huang's Pj AC */
+struct si_pj_huang_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *, typename M::real *k)
+  {
+    typedef typename M::real R;
+
+    k[0] = (R) 1.0 + (R) 0.073456 * (site_index - (R) 1.3);
+    k[1] = M::log (site_index - (R) 1.3);
+    k[2] = k[0] + M::exp ((R) 8.770517 + (R) -1.334706 *
+      M::log ((R) 49.5 + (R) 1.719841) - k[1]);
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real site_index, typename M::real bhage, const typename M::real *)
+  {
+    typedef typename M::real R;
+    R x5;
+
+    x5 = k[2] / (k[0] + M::exp ((R) 8.770517 + (R) -1.334706 *
+      M::log (bhage - (R) 0.5 + (R) 1.719841) - k[1]));
+
+    return (R) 1.3 + (site_index - (R) 1.3) * x5;
+  }
+};
+
+/*
+ * Wiley's Hwc AC, in feet, with a bump to age 10.  Above the line where
+ * site index outgrows age, height runs straight from breast height to
+ * the curve at a safe age, which depends only on site index and pi.
+ */
+struct si_hwc_wiley_form : si_form
+{
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real curve (const typename M::real *k, typename M::real bhage, typename M::real pi)
+  {
+    typedef typename M::real R;
+    R x5, ht;
+
+    x5 = bhage - pi;
+    ht = (R) 4.5 + x5 * x5 / (k[0] + k[1] * x5 + k[2] * x5 * x5);
+    ht = (x5 < (R) 5) ? ht + (R) 0.3 * x5 :
+      ((x5 < (R) 10) ? ht + ((R) 3.0 - (R) 0.3 * x5) : ht);
+
+    return ht * (R) 0.3048;
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE void pi_terms (typename M::real pi, typename M::real *p)
+  {
+    typedef typename M::real R;
+
+    p[0] = pi;
+    p[1] = M::pow ((R) 49 + ((R) 1 - pi), (R) 2.0);
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE void unit (typename M::real site_index, const typename M::real *p, typename M::real *k)
+  {
+    typedef typename M::real R;
+    R x1;
+
+    x1 = p[1] / (site_index / (R) 0.3048 - (R) 4.5);
+    k[0] = (R) -1.7307 + (R) 0.1394 * x1;
+    k[1] = (R) -0.0616 + (R) 0.0137 * x1;
+    k[2] = (R) 0.00195078 + (R) 0.00007446 * x1;
+    k[3] = (site_index - 60) / (R) 1.667 + (R) 0.1 + p[0];
+    k[4] = curve<C, M> (k, k[3], p[0]);
+  }
+
+  template <class C, class M>
+  static SI_MATH_INLINE typename M::real height (const typename M::real *k, typename M::real site_index, typename M::real bhage, const typename M::real *p)
+  {
+    typedef typename M::real R;
+    R pi;
+
+    pi = p[0];
+    if (M::branch_free)
+      return (site_index > 60 + (R) 1.667 * (bhage - pi)) ?
+        (R) 1.37 + (k[4] - (R) 1.37) * (bhage - pi) / k[3] :
+        curve<C, M> (k, bhage, pi);
+
+    if (site_index > 60 + (R) 1.667 * (bhage - pi))
+      return (R) 1.37 + (k[4] - (R) 1.37) * (bhage - pi) / k[3];
+    return curve<C, M> (k, bhage, pi);
+  }
+};
+
+
+/*
+ * approaches to breast height, from total age and y2bh (with its 0.5
+ * added), below the curve's least breast height age, or pi
+ */
+
+/* the usual quadratic */
+struct si_quad_below
+{
+  template <class M>
+  static SI_MATH_INLINE typename M::real height (typename M::real tage, typename M::real y)
+  {
+    typedef typename M::real R;
+
+    return tage * tage * (R) 1.3 / y / y;
+  }
+};
+
+/* Nigh's At */
+struct si_at_nigh_below
+{
+  template <class M>
+  static SI_MATH_INLINE typename M::real height (typename M::real tage, typename M::real y)
+  {
+    typedef typename M::real R;
+
+    return M::pow (tage / y, (R) 1.5) * (R) 1.3;
+  }
+};
+
+/* Nigh's Py */
+struct si_py_nigh_below
+{
+  template <class M>
+  static SI_MATH_INLINE typename M::real height (typename M::real tage, typename M::real y)
+  {
+    typedef typename M::real R;
+
+    return ((R) 1.3 * M::pow (tage, (R) 1.137) * M::pow ((R) 1.016, tage)) /
+      (M::pow (y, (R) 1.137) * M::pow ((R) 1.016, y));
+  }
+};
+
+/* the quadratic, to 1.37 m */
+struct si_quad137_below
+{
+  template <class M>
+  static SI_MATH_INLINE typename M::real height (typename M::real tage, typename M::real y)
+  {
+    typedef typename M::real R;
+
+    return tage * tage * (R) 1.37 / y / y;
+  }
+};
+
+/* Nigh's Pli */
+struct si_pli_nigh_below
+{
+  template <class M>
+  static SI_MATH_INLINE typename M::real height (typename M::real tage, typename M::real y)
+  {
+    typedef typename M::real R;
+
+    return (R) 1.3 * M::pow (tage / y, (R) 1.77 - (R) 0.1028 * y) *
+      M::pow ((R) 1.179, tage - y);
+  }
+};
+
+/* Nigh's Sw */
+struct si_sw_nigh_below
+{
+  template <class M>
+  static SI_MATH_INLINE typename M::real height (typename M::real tage, typename M::real y)
+  {
+    typedef typename M::real R;
+
+    return (R) 1.3 * M::pow (tage / y, (R) 1.628 - (R) 0.05991 * y) *
+      M::pow ((R) 1.127, tage - y);
+  }
+};
+
+
+/*
+ * curve traits.  The curve is used above bh_min, or for curves with ages
+ * from pi, above pi or from pi on, as the curve's equation says.
+ */
+template <short int CU> struct si_curve_traits;
+
+#define SI_BH_MIN      0
+#define SI_BH_ABOVE_PI 1
+#define SI_BH_FROM_PI  2
+
+#define SI_TRAITS(cu, form_, rule, bhmin, c1, c2, c3) \
+  SI_TRAITS_BELOW (cu, form_, si_quad_below, rule, bhmin, c1, c2, c3)
+
+#define SI_TRAITS_BELOW(cu, form_, below_, rule, bhmin, c1, c2, c3) \
+  SI_TRAITS_ALL (cu, form_, below_, rule, SI_BH_MIN, bhmin, c1, c2, c3)
+
+#define SI_TRAITS_PI(cu, form_, below_, rule, bhfrom, c1, c2, c3) \
+  SI_TRAITS_ALL (cu, form_, below_, rule, bhfrom, 0.0, c1, c2, c3)
+
+#define SI_TRAITS_ALL(cu, form_, below_, rule, bhfrom, bhmin, c1, c2, c3) \
+template <> struct si_curve_traits<cu> \
+{ \
+  typedef form_ form; \
+  typedef below_ below; \
+  static constexpr double age_corr = ((rule) == SI_AGE_AC) ? 0.5 : 0.0; \
+  static constexpr int bh_from = bhfrom; \
+  static constexpr double bh_min = bhmin; \
+  static constexpr double x1 = c1; \
+  static constexpr double x2 = c2; \
+  static constexpr double x3 = c3; \
+};
+
+#ifdef SI_PLI_GOUDIE_DRY
+SI_TRAITS (SI_PLI_GOUDIE_DRY, si_goudie_form, SI_AGE_STD, 0.0, -1.00726, 7.81498, -1.28517)
+#endif
+#ifdef SI_PLI_GOUDIE_WET
+SI_TRAITS (SI_PLI_GOUDIE_WET, si_goudie_form, SI_AGE_STD, 0.0, -0.935, 7.81498, -1.28517)
+#endif
+#ifdef SI_PLI_DEMPSTER
+SI_TRAITS (SI_PLI_DEMPSTER, si_goudie_form, SI_AGE_STD, 0.0, -0.9576, 7.4871, -1.2036)
+#endif
+#ifdef SI_SW_GOUDIE_PLA
+SI_TRAITS (SI_SW_GOUDIE_PLA, si_goudie_form, SI_AGE_STD, 0.0, -1.2866, 9.7936, -1.4661)
+#endif
+#ifdef SI_SW_GOUDIE_NAT
+SI_TRAITS (SI_SW_GOUDIE_NAT, si_goudie_form, SI_AGE_STD, 0.0, -1.2866, 9.7936, -1.4661)
+#endif
+#ifdef SI_SW_DEMPSTER
+SI_TRAITS (SI_SW_DEMPSTER, si_goudie_form, SI_AGE_STD, 0.0, -1.2240, 9.6183, -1.4627)
+#endif
+#ifdef SI_SB_DEMPSTER
+SI_TRAITS (SI_SB_DEMPSTER, si_goudie_form, SI_AGE_STD, 0.0, -1.3154, 8.5594, -1.1484)
+#endif
+#ifdef SI_SS_GOUDIE
+SI_TRAITS (SI_SS_GOUDIE, si_goudie_form, SI_AGE_STD, 0.0, -1.5282, 11.0605, -1.5108)
+#endif
+#ifdef SI_FDI_THROWER
+SI_TRAITS (SI_FDI_THROWER, si_goudie_form, SI_AGE_STD, 0.0, -0.237724692, 5.780089777, -1.150039266)
+#endif
+#ifdef SI_AT_GOUDIE
+SI_TRAITS (SI_AT_GOUDIE, si_goudie_form, SI_AGE_STD, 0.0, -0.618, 6.879, -1.32)
+#endif
+
+#ifdef SI_SS_NIGH
+SI_TRAITS (SI_SS_NIGH, si_nigh_form, SI_AGE_AC, 0.5, 8.947, -1.357, -1.013)
+#endif
+#ifdef SI_EP_NIGH
+SI_TRAITS (SI_EP_NIGH, si_nigh_form, SI_AGE_AC, 0.5, 9.604, -1.113, -1.849)
+#endif
+#ifdef SI_CWI_NIGH
+SI_TRAITS (SI_CWI_NIGH, si_nigh_form, SI_AGE_AC, 0.5, 9.474, -1.340, -1.244)
+#endif
+#ifdef SI_HWI_NIGH
+SI_TRAITS (SI_HWI_NIGH, si_nigh_form, SI_AGE_AC, 0.5, 8.998, -1.434, -1.051)
+#endif
+#ifdef SI_PY_NIGH
+SI_TRAITS_BELOW (SI_PY_NIGH, si_nigh_form, si_py_nigh_below, SI_AGE_AC, 0.5, 8.519, -1.385, -0.8498)
+#endif
+#ifdef SI_SB_NIGH
+SI_TRAITS (SI_SB_NIGH, si_nigh_log_form, SI_AGE_AC, 0.5, 9.086, -1.052, -1.55)
+#endif
+#ifdef SI_AT_NIGH
+SI_TRAITS_BELOW (SI_AT_NIGH, si_nigh_log_form, si_at_nigh_below, SI_AGE_AC, 0.5, 7.423, -1.15, -0.9614)
+#endif
+
+/* forms with coefficients of their own */
+#ifdef SI_BA_NIGH
+SI_TRAITS (SI_BA_NIGH, si_ba_nigh_form, SI_AGE_AC, 0.5, 0.0, 0.0, 0.0)
+#endif
+#ifdef SI_CWC_NIGH
+SI_TRAITS (SI_CWC_NIGH, si_cwc_nigh_form, SI_AGE_STD, 0.5, 0.0, 0.0, 0.0)
+#endif
+#ifdef SI_DR_NIGH
+SI_TRAITS (SI_DR_NIGH, si_dr_nigh_form, SI_AGE_AC, 0.5, 0.0, 0.0, 0.0)
+#endif
+#ifdef SI_LW_NIGH
+SI_TRAITS (SI_LW_NIGH, si_lw_nigh_form, SI_AGE_AC, 0.5, 0.0, 0.0, 0.0)
+#endif
+#ifdef SI_SE_NIGH
+SI_TRAITS (SI_SE_NIGH, si_se_nigh_form, SI_AGE_STD, 0.5, 0.0, 0.0, 0.0)
+#endif
+
+/* the other species defaults, with ages from 0.5 or pi */
+#ifdef SI_BL_CHENAC
+SI_TRAITS (SI_BL_CHENAC, si_nigh_form, SI_AGE_AC, 0.5, 9.523, -1.4945, -1.2159)
+#endif
+#ifdef SI_FDI_THROWERAC
+SI_TRAITS (SI_FDI_THROWERAC, si_goudie_ac_form, SI_AGE_AC, 0.5, -0.237724692, 5.780089777, -1.150039266)
+#endif
+#ifdef SI_ACT_THROWERAC
+SI_TRAITS (SI_ACT_THROWERAC, si_goudie_ac_form, SI_AGE_AC, 0.5, -1.6555, 10.3861, -1.3481)
+#endif
+#ifdef SI_PLI_THROWER
+SI_TRAITS_PI (SI_PLI_THROWER, si_goudie_pi_form, si_pli_nigh_below, SI_AGE_AC, SI_BH_ABOVE_PI, -0.8940, 7.6298, -1.3563)
+#endif
+#ifdef SI_SW_GOUDIE_PLAAC
+SI_TRAITS_PI (SI_SW_GOUDIE_PLAAC, si_goudie_pi_form, si_sw_nigh_below, SI_AGE_AC, SI_BH_ABOVE_PI, -1.2866, 9.7936, -1.4661)
+#endif
+#ifdef SI_BP_CURTISAC
+SI_TRAITS_BELOW (SI_BP_CURTISAC, si_bp_curtis_form, si_quad137_below, SI_AGE_AC, 0.5, 0.0, 0.0, 0.0)
+#endif
+#ifdef SI_PW_CURTISAC
+SI_TRAITS_BELOW (SI_PW_CURTISAC, si_pw_curtis_form, si_quad137_below, SI_AGE_AC, 0.5, 0.0, 0.0, 0.0)
+#endif
+#ifdef SI_HM_MEANSAC
+SI_TRAITS_BELOW (SI_HM_MEANSAC, si_hm_means_form, si_quad137_below, SI_AGE_AC, 0.5, 0.0, 0.0, 0.0)
+#endif
+#ifdef SI_ACB_HUANGAC
+SI_TRAITS (SI_ACB_HUANGAC, si_acb_huang_form, SI_AGE_AC, 0.5, 0.0, 0.0, 0.0)
+#endif
+#ifdef SI_PJ_HUANGAC
+SI_TRAITS (SI_PJ_HUANGAC, si_pj_huang_form, SI_AGE_AC, 0.5, 0.0, 0.0, 0.0)
+#endif
+#ifdef SI_HWC_WILEYAC
+SI_TRAITS_PI (SI_HWC_WILEYAC, si_hwc_wiley_form, si_quad137_below, SI_AGE_AC, SI_BH_FROM_PI, 0.0, 0.0, 0.0)
+#endif
+
+#ifdef SI_PLI_CIESZEWSKI
+SI_TRAITS (SI_PLI_CIESZEWSKI, si_cieszewski_form, SI_AGE_STD, 0.0, 0.20372424, 97.37473618, 0.0)
+#endif
+#ifdef SI_SW_CIESZEWSKI
+SI_TRAITS (SI_SW_CIESZEWSKI, si_cieszewski_form, SI_AGE_STD, 0.0, 0.3235139, 260.9162652, 0.0)
+#endif
+#ifdef SI_SB_CIESZEWSKI
+SI_TRAITS (SI_SB_CIESZEWSKI, si_cieszewski_form, SI_AGE_STD, 0.0, 0.1992266, 114.8730018, 0.0)
+#endif
+#ifdef SI_AT_CIESZEWSKI
+SI_TRAITS (SI_AT_CIESZEWSKI, si_cieszewski_form, SI_AGE_STD, 0.0, 0.2644606, 117.3695371, 0.0)
+#endif
+
+
+/*
+ * the kernel body, in the floating type of M.  the age conversion and the
+ * checks up front are those of index_to_height() and age_to_age(), with
+ * the curve's rule built in.  pi enters only the curves with ages from
+ * it.  Where the loop stays scalar, the terms of a site index are kept
+ * while rows repeat it, as the rows of a yield table do.
+ */
+template <short int CU, class M>
+static SI_INLINE bool si_ht_above (typename M::real bhage, typename M::real pi)
+{
+  typedef si_curve_traits<CU> C;
+  typedef typename M::real R;
+
+  if (C::bh_from == SI_BH_ABOVE_PI)
+    return bhage > pi;
+  if (C::bh_from == SI_BH_FROM_PI)
+    return bhage >= pi;
+  return bhage > (R) C::bh_min;
+}
+
+template <short int CU, class M>
+static SI_INLINE void si_ht_rows (
+  int n,
+  const typename M::real *age,
+  const int *age_type,
+  const typename M::real *site_index,
+  const typename M::real *y2bh,
+  typename M::real pi,
+  typename M::real *height)
+{
+  typedef si_curve_traits<CU> C;
+  typedef typename M::real R;
+  int i;
+  R si, y, tage, bhage, ht, last;
+  R k[SI_FORM_TERMS], p[SI_PI_TERMS];
+
+
+  C::form::template pi_terms<C, M> (pi, p);
+
+  /* no site index yet */
+  last = (R) NAN;
+  for (i = 0; i < SI_FORM_TERMS; i++)
+    k[i] = 0;
+
+  for (i = 0; i < n; i++)
+  {
+    si = site_index[i];
+    y = ((int) y2bh[i]) + (R) 0.5;
+
+    if (age_type[i] == SI_AT_TOTAL)
+    {
+      tage = age[i];
+      bhage = tage - y + (R) C::age_corr;
+      if (bhage < 0)
+        bhage = 0;
+    }
+    else
+    {
+      bhage = age[i];
+      tage = bhage + y - (R) C::age_corr;
+      if (tage < 0)
+        tage = 0;
+    }
+
+    if (M::branch_free)
+    {
+      /*
+       * the checks of index_to_height(), last one first, as selects
+       * rather than branches so the loop can be vectorised
+       */
+      C::form::template unit<C, M> (si, p, k);
+      ht = C::form::template height<C, M> (k, si, bhage, p);
+      ht = si_ht_above<CU, M> (bhage, pi) ? ht : C::below::template height<M> (tage, y);
+      ht = (tage < (R) 0.00001) ? (R) 0.0 : ht;
+      ht = (tage < (R) 0.0) ? (R) SI_ERR_NO_ANS : ht;
+      ht = (si < (R) 1.3) ? (R) SI_ERR_LT13 : ht;
+    }
+    else
+    {
+      /* library calls keep the loop scalar, so only take the curve if needed */
+      if (si < (R) 1.3)
+        ht = (R) SI_ERR_LT13;
+      else if (tage < (R) 0.0)
+        ht = (R) SI_ERR_NO_ANS;
+      else if (tage < (R) 0.00001)
+        ht = (R) 0.0;
+      else if (si_ht_above<CU, M> (bhage, pi))
+      {
+        if (!(si == last))
+        {
+          C::form::template unit<C, M> (si, p, k);
+          last = si;
+        }
+        ht = C::form::template height<C, M> (k, si, bhage, p);
+      }
+      else
+        ht = C::below::template height<M> (tage, y);
+    }
+    height[i] = ht;
+  }
+}
+
+
+template <short int CU, class M>
+SI_VECTORISE
+static void si_ht_kernel (
+  short int,
+  int n,
+  const typename M::real *age,
+  const int *age_type,
+  const typename M::real *site_index,
+  const typename M::real *y2bh,
+  typename M::real pi,
+  typename M::real *height)
+{
+  si_ht_rows<CU, M> (n, age, age_type, site_index, y2bh, pi, height);
+}
+
+#ifdef SI_DISPATCH
+template <short int CU, class M>
+SI_TARGET ("avx2")
+static void si_ht_kernel_avx2 (
+  short int,
+  int n,
+  const typename M::real *age,
+  const int *age_type,
+  const typename M::real *site_index,
+  const typename M::real *y2bh,
+  typename M::real pi,
+  typename M::real *height)
+{
+  si_ht_rows<CU, M> (n, age, age_type, site_index, y2bh, pi, height);
+}
+
+template <short int CU, class M>
+SI_TARGET ("avx512f")
+static void si_ht_kernel_avx512 (
+  short int,
+  int n,
+  const typename M::real *age,
+  const int *age_type,
+  const typename M::real *site_index,
+  const typename M::real *y2bh,
+  typename M::real pi,
+  typename M::real *height)
+{
+  si_ht_rows<CU, M> (n, age, age_type, site_index, y2bh, pi, height);
+}
+#endif
+
+
+/*
+ * the math used by the base build in place of M.  The SSE2 build of the
+ * double polynomial tiers does not vectorise, and is slower there than
+ * the C library, so the exact tier stands in for them.
+ */
+template <class M> struct si_base_math { typedef M type; };
+#if defined(__x86_64__)
+template <> struct si_base_math<si_math<SI_MATH_ULP> > { typedef si_math<SI_MATH_EXACT> type; };
+template <> struct si_base_math<si_math<SI_MATH_FAST> > { typedef si_math<SI_MATH_EXACT> type; };
+#endif
+
+/* the build of a curve's kernel for the chosen level */
+template <short int CU, class M>
+static SI_HT_BATCH si_ht_pick (void)
+{
+#ifdef SI_DISPATCH
+  if (si_isa == SI_ISA_AVX512)
+    return si_ht_kernel_avx512<CU, M>;
+  if (si_isa == SI_ISA_AVX2)
+    return si_ht_kernel_avx2<CU, M>;
+#endif
+  return si_ht_kernel<CU, typename si_base_math<M>::type>;
+}
+
+
+/* rows of a gradient kernel put in dual numbers at a time */
+#define SI_GRAD_ROWS 64
+
+/*
+ * a curve's gradient kernel: the kernel body on dual numbers, seeded
+ * with the derivatives of site index and age by themselves.
+ */
+template <short int CU>
+static void si_ht_grad_kernel (
+  short int,
+  int n,
+  const double *age,
+  const int *age_type,
+  const double *site_index,
+  const double *y2bh,
+  double pi,
+  double *height,
+  double *d_site,
+  double *d_age)
+{
+  si_dual g_age[SI_GRAD_ROWS], g_si[SI_GRAD_ROWS], g_y2bh[SI_GRAD_ROWS];
+  si_dual g_ht[SI_GRAD_ROWS];
+  int i, j, m;
+
+
+  for (i = 0; i < n; i += SI_GRAD_ROWS)
+  {
+    m = (n - i < SI_GRAD_ROWS) ? n - i : SI_GRAD_ROWS;
+    for (j = 0; j < m; j++)
+    {
+      g_age[j] = si_dual (age[i + j], 0, 1);
+      g_si[j] = si_dual (site_index[i + j], 1, 0);
+      g_y2bh[j] = si_dual (y2bh[i + j]);
+    }
+
+    si_ht_rows<CU, si_math_dual> (m, g_age, age_type + i, g_si, g_y2bh,
+      si_dual (pi), g_ht);
+
+    for (j = 0; j < m; j++)
+    {
+      height[i + j] = g_ht[j].v;
+      d_site[i + j] = g_ht[j].d[0];
+      d_age[i + j] = g_ht[j].d[1];
+    }
+  }
+}
+
+
+/*
+ * picks the widest level the CPU supports, no wider than the one named
+ * in SINDEX_KERNEL_ISA, if set.
+ */
+static int si_isa_detect (void)
+{
+  int level, i;
+  const char *env;
+
+
+  level = SI_ISA_BASE;
+#ifdef SI_DISPATCH
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx512f"))
+    level = SI_ISA_AVX512;
+  else if (__builtin_cpu_supports ("avx2"))
+    level = SI_ISA_AVX2;
+#endif
+
+  env = getenv ("SINDEX_KERNEL_ISA");
+  if (env != NULL)
+  {
+    for (i = SI_ISA_BASE; i <= SI_ISA_AVX512; i++)
+      if (strcmp (env, si_isa_name[i]) == 0 && i < level)
+        level = i;
+  }
+
+  return level;
+}
+
+
+#define SI_INSTALL(cu) \
+  reg[cu].height_tier[SI_MATH_EXACT] = si_ht_pick<cu, si_math<SI_MATH_EXACT> > (); \
+  reg[cu].height_tier[SI_MATH_ULP] = si_ht_pick<cu, si_math<SI_MATH_ULP> > (); \
+  reg[cu].height_tier[SI_MATH_FAST] = si_ht_pick<cu, si_math<SI_MATH_FAST> > (); \
+  reg[cu].height_n = reg[cu].height_tier[SI_MATH_EXACT]; \
+  reg[cu].height_grad = si_ht_grad_kernel<cu>; \
+  reg[cu].kernel = 1;
+
+void si_kernel_install (SI_CURVE *reg)
+{
+  si_isa = si_isa_detect ();
+
+#ifdef SI_PLI_GOUDIE_DRY
+  SI_INSTALL (SI_PLI_GOUDIE_DRY)
+#endif
+#ifdef SI_PLI_GOUDIE_WET
+  SI_INSTALL (SI_PLI_GOUDIE_WET)
+#endif
+#ifdef SI_PLI_DEMPSTER
+  SI_INSTALL (SI_PLI_DEMPSTER)
+#endif
+#ifdef SI_SW_GOUDIE_PLA
+  SI_INSTALL (SI_SW_GOUDIE_PLA)
+#endif
+#ifdef SI_SW_GOUDIE_NAT
+  SI_INSTALL (SI_SW_GOUDIE_NAT)
+#endif
+#ifdef SI_SW_DEMPSTER
+  SI_INSTALL (SI_SW_DEMPSTER)
+#endif
+#ifdef SI_SB_DEMPSTER
+  SI_INSTALL (SI_SB_DEMPSTER)
+#endif
+#ifdef SI_SS_GOUDIE
+  SI_INSTALL (SI_SS_GOUDIE)
+#endif
+#ifdef SI_FDI_THROWER
+  SI_INSTALL (SI_FDI_THROWER)
+#endif
+#ifdef SI_AT_GOUDIE
+  SI_INSTALL (SI_AT_GOUDIE)
+#endif
+#ifdef SI_SS_NIGH
+  SI_INSTALL (SI_SS_NIGH)
+#endif
+#ifdef SI_EP_NIGH
+  SI_INSTALL (SI_EP_NIGH)
+#endif
+#ifdef SI_CWI_NIGH
+  SI_INSTALL (SI_CWI_NIGH)
+#endif
+#ifdef SI_HWI_NIGH
+  SI_INSTALL (SI_HWI_NIGH)
+#endif
+#ifdef SI_PY_NIGH
+  SI_INSTALL (SI_PY_NIGH)
+#endif
+#ifdef SI_SB_NIGH
+  SI_INSTALL (SI_SB_NIGH)
+#endif
+#ifdef SI_AT_NIGH
+  SI_INSTALL (SI_AT_NIGH)
+#endif
+#ifdef SI_BA_NIGH
+  SI_INSTALL (SI_BA_NIGH)
+#endif
+#ifdef SI_CWC_NIGH
+  SI_INSTALL (SI_CWC_NIGH)
+#endif
+#ifdef SI_DR_NIGH
+  SI_INSTALL (SI_DR_NIGH)
+#endif
+#ifdef SI_LW_NIGH
+  SI_INSTALL (SI_LW_NIGH)
+#endif
+#ifdef SI_SE_NIGH
+  SI_INSTALL (SI_SE_NIGH)
+#endif
+#ifdef SI_PLI_CIESZEWSKI
+  SI_INSTALL (SI_PLI_CIESZEWSKI)
+#endif
+#ifdef SI_SW_CIESZEWSKI
+  SI_INSTALL (SI_SW_CIESZEWSKI)
+#endif
+#ifdef SI_SB_CIESZEWSKI
+  SI_INSTALL (SI_SB_CIESZEWSKI)
+#endif
+#ifdef SI_AT_CIESZEWSKI
+  SI_INSTALL (SI_AT_CIESZEWSKI)
+#endif
+#ifdef SI_BL_CHENAC
+  SI_INSTALL (SI_BL_CHENAC)
+#endif
+#ifdef SI_FDI_THROWERAC
+  SI_INSTALL (SI_FDI_THROWERAC)
+#endif
+#ifdef SI_ACT_THROWERAC
+  SI_INSTALL (SI_ACT_THROWERAC)
+#endif
+#ifdef SI_PLI_THROWER
+  SI_INSTALL (SI_PLI_THROWER)
+#endif
+#ifdef SI_SW_GOUDIE_PLAAC
+  SI_INSTALL (SI_SW_GOUDIE_PLAAC)
+#endif
+#ifdef SI_BP_CURTISAC
+  SI_INSTALL (SI_BP_CURTISAC)
+#endif
+#ifdef SI_PW_CURTISAC
+  SI_INSTALL (SI_PW_CURTISAC)
+#endif
+#ifdef SI_HM_MEANSAC
+  SI_INSTALL (SI_HM_MEANSAC)
+#endif
+#ifdef SI_ACB_HUANGAC
+  SI_INSTALL (SI_ACB_HUANGAC)
+#endif
+#ifdef SI_PJ_HUANGAC
+  SI_INSTALL (SI_PJ_HUANGAC)
+#endif
+#ifdef SI_HWC_WILEYAC
+  SI_INSTALL (SI_HWC_WILEYAC)
+#endif
+}
+
+
+/*
+ * returns the instruction set the kernels were chosen for.
+ */
+const char *si_kernel_isa (void)
+{
+  si_curve (0);  /* make sure the registry is built */
+
+  return si_isa_name[si_isa];
+}
+
+
+// [[Rcpp::export]]
+std::string Sindex_KernelISA ()
+{
+  return si_kernel_isa ();
+}
+
+
+/*
+ * times each curve's batch height kernel at each math tier, over a grid
+ * of ages and site indices, and measures its largest departure from the
+ * exact tier.  Rows the exact tier gives an error code for count only
+ * if the tier gives a different code.
+ */
+// [[Rcpp::export]]
+DataFrame Sindex_MathTierReport (int reps)
+{
+  static const char *const tier_name[SI_MATH_TIERS] = { "exact", "ulp", "fast" };
+  std::vector<double> age, si, y2bh, exact, ht;
+  std::vector<int> type;
+  const SI_CURVE *cu;
+  int n, c, t, r, i, row;
+  double a, s, err, rel, max_err, max_rel;
+  std::chrono::steady_clock::time_point t0, t1;
+
+  IntegerVector out_curve (SI_MAX_CURVES * SI_MATH_TIERS);
+  CharacterVector out_tier (SI_MAX_CURVES * SI_MATH_TIERS);
+  LogicalVector out_kernel (SI_MAX_CURVES * SI_MATH_TIERS);
+  NumericVector out_ns (SI_MAX_CURVES * SI_MATH_TIERS);
+  NumericVector out_err (SI_MAX_CURVES * SI_MATH_TIERS);
+  NumericVector out_rel (SI_MAX_CURVES * SI_MATH_TIERS);
+
+
+  if (reps < 1)
+    reps = 1;
+
+  row = 0;
+  for (c = 0; c < SI_MAX_CURVES; c++)
+  {
+    cu = si_curve ((short int) c);
+
+    age.clear ();
+    si.clear ();
+    y2bh.clear ();
+    type.clear ();
+    for (s = 3; s <= 60; s += 3)
+      for (a = 1; a <= 250; a += 1)
+        for (i = SI_AT_TOTAL; i <= SI_AT_BREAST; i++)
+        {
+          age.push_back (a);
+          si.push_back (s);
+          y2bh.push_back (si_y2bh ((short int) c, s));
+          type.push_back (i);
+        }
+    n = (int) age.size ();
+    exact.resize (n);
+    ht.resize (n);
+
+    cu->height_tier[SI_MATH_EXACT] ((short int) c, n, age.data (), type.data (),
+      si.data (), y2bh.data (), 0.5, exact.data ());
+
+    for (t = 0; t < SI_MATH_TIERS; t++)
+    {
+      t0 = std::chrono::steady_clock::now ();
+      for (r = 0; r < reps; r++)
+        cu->height_tier[t] ((short int) c, n, age.data (), type.data (),
+          si.data (), y2bh.data (), 0.5, ht.data ());
+      t1 = std::chrono::steady_clock::now ();
+
+      max_err = 0;
+      max_rel = 0;
+      for (i = 0; i < n; i++)
+      {
+        if (exact[i] < 0 || ht[i] < 0)
+        {
+          if (ht[i] != exact[i])
+          {
+            max_err = HUGE_VAL;
+            max_rel = HUGE_VAL;
+          }
+          continue;
+        }
+        err = fabs (ht[i] - exact[i]);
+        rel = (exact[i] > 0) ? err / exact[i] : err;
+        if (err > max_err)
+          max_err = err;
+        if (rel > max_rel)
+          max_rel = rel;
+      }
+
+      out_curve[row] = c;
+      out_tier[row] = tier_name[t];
+      out_kernel[row] = cu->kernel;
+      out_ns[row] = std::chrono::duration<double, std::nano> (t1 - t0).count () /
+        ((double) n * reps);
+      out_err[row] = max_err;
+      out_rel[row] = max_rel;
+      row++;
+    }
+  }
+
+  return DataFrame::create (
+    Named ("curve") = out_curve,
+    Named ("tier") = out_tier,
+    Named ("kernel") = out_kernel,
+    Named ("ns_per_row") = out_ns,
+    Named ("max_abs_err") = out_err,
+    Named ("max_rel_err") = out_rel,
+    Named ("stringsAsFactors") = false);
+}
@@ -0,0 +1,411 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * simonte.c
+ * - Monte Carlo uncertainty of site index from height and age, or of
+ *   height from site index and age: each row's inputs are drawn many
+ *   times with normal errors of the row's standard deviations, and the
+ *   results summarised by their mean, standard deviation and quantiles.
+ * - draws come from Philox4x32-10, a counter-based generator: the draws
+ *   of a sample are a function of the seed, the row and the sample
+ *   only.  Each row's summary is made from its own samples in order, so
+ *   results are the same for any number of threads.
+ * - rows are cut into blocks of about SI_MC_CELLS samples, and blocks
+ *   shared among threads as in siyield.c.  A block's samples are handed
+ *   to si_index_batch() or si_height_batch() in one call, then
+ *   summarised; only one block's samples are held by each thread.
+ * - samples giving an error code, or missing, are left out of the
+ *   summary.  Each row's value without errors, and its error code, are
+ *   also given.
+ *
+ * 2026 oct 18 - Created.
+ */
+
+
+/* samples in a block */
+#define SI_MC_CELLS 4096
+
+/* a summary being made, shared by its threads */
+typedef struct
+  {
+  int           n;
+  const int    *cu_index;
+  const double *age;
+  const int    *age_type;
+  const double *value;      /* height, or site index */
+  const double *y2bh;       /* for SI_MC_HEIGHT */
+  const double *sd_value;
+  const double *sd_age;
+  int           what;       /* SI_MC_xxx */
+  int           est_type;
+  double        pi;
+  int           samples;
+  uint64_t      seed;
+  int           q;
+  const double *prob;
+  int           tier;
+  int           rows;       /* rows in a block */
+  double       *point;      /* returned values without errors, or NaN */
+  signed char  *code;
+  double       *mean;
+  double       *sd;
+  double       *quantile;   /* n by q */
+  int          *valid;
+  std::atomic<int> next;    /* block to take */
+  } SI_MC_JOB;
+
+
+/* a thread's samples for one block */
+typedef struct
+  {
+  std::vector<int>    cu;
+  std::vector<double> age;
+  std::vector<int>    type;
+  std::vector<double> value;
+  std::vector<double> y2bh;
+  std::vector<int>    est;
+  std::vector<double> out;
+  std::vector<signed char> code;
+  std::vector<double> kept;
+  } SI_MC_ROWS;
+
+
+/*
+ * Philox4x32-10 of Salmon et al. (2011), four 32 bit words from a 128
+ * bit counter and 64 bit key.
+ */
+static void si_philox (uint32_t c[4], uint64_t seed)
+{
+  uint32_t k0, k1, x0, x1, x2, x3;
+  uint64_t p0, p1;
+  int r;
+
+
+  k0 = (uint32_t) seed;
+  k1 = (uint32_t) (seed >> 32);
+  x0 = c[0];
+  x1 = c[1];
+  x2 = c[2];
+  x3 = c[3];
+  for (r = 0; r < 10; r++)
+  {
+    if (r > 0)
+    {
+      k0 += 0x9E3779B9;
+      k1 += 0xBB67AE85;
+    }
+    p0 = (uint64_t) 0xD2511F53 * x0;
+    p1 = (uint64_t) 0xCD9E8D57 * x2;
+    x0 = (uint32_t) (p1 >> 32) ^ x1 ^ k0;
+    x2 = (uint32_t) (p0 >> 32) ^ x3 ^ k1;
+    x1 = (uint32_t) p1;
+    x3 = (uint32_t) p0;
+  }
+  c[0] = x0;
+  c[1] = x1;
+  c[2] = x2;
+  c[3] = x3;
+}
+
+
+/* two standard normals for a sample of a row, by Box-Muller */
+static void si_mc_normals (uint64_t seed, int row, int sample, double z[2])
+{
+  uint32_t c[4];
+  double u1, u2, r;
+
+
+  c[0] = (uint32_t) sample;
+  c[1] = (uint32_t) row;
+  c[2] = 0;
+  c[3] = 0;
+  si_philox (c, seed);
+
+  /* 53 bit uniforms in (0, 1) */
+  u1 = ((double) (((uint64_t) c[0] << 21) | (c[1] >> 11)) + 0.5) / 9007199254740992.0;
+  u2 = ((double) (((uint64_t) c[2] << 21) | (c[3] >> 11)) + 0.5) / 9007199254740992.0;
+  r = sqrt (-2 * log (u1));
+  z[0] = r * cos (2 * M_PI * u2);
+  z[1] = r * sin (2 * M_PI * u2);
+}
+
+
+/* quantile p of x[0..m), as R's quantile() type 7; x is reordered */
+static double si_mc_quantile (double *x, int m, double p)
+{
+  double h, lo;
+  int k;
+
+
+  h = (m - 1) * p;
+  k = (int) floor (h);
+  std::nth_element (x, x + k, x + m);
+  lo = x[k];
+  if (h == k)
+    return lo;
+  return lo + (h - k) * (*std::min_element (x + k + 1, x + m) - lo);
+}
+
+
+static void si_mc_block (SI_MC_JOB *job, int first, SI_MC_ROWS *r)
+{
+  int rows, cells, i, j, s, c, m;
+  double z[2], sum, dev;
+
+
+  rows = std::min (job->rows, job->n - first);
+  cells = rows * (job->samples + 1);
+  r->cu.resize (cells);
+  r->age.resize (cells);
+  r->type.resize (cells);
+  r->value.resize (cells);
+  r->y2bh.resize (cells);
+  r->est.resize (cells);
+  r->out.resize (cells);
+  r->code.resize (cells);
+  r->kept.resize (job->samples);
+
+  /* each row's value without errors, then its samples */
+  c = 0;
+  for (i = first; i < first + rows; i++)
+    for (s = -1; s < job->samples; s++)
+    {
+      r->cu[c] = job->cu_index[i];
+      r->type[c] = job->age_type[i];
+      r->y2bh[c] = (job->what == SI_MC_HEIGHT) ? job->y2bh[i] : 0;
+      r->est[c] = job->est_type;
+      r->age[c] = job->age[i];
+      r->value[c] = job->value[i];
+      if (s >= 0)
+      {
+        si_mc_normals (job->seed, i, s, z);
+        r->value[c] += z[0] * job->sd_value[i];
+        r->age[c] += z[1] * job->sd_age[i];
+      }
+      c++;
+    }
+
+  if (job->what == SI_MC_HEIGHT)
+    si_height_batch (cells, r->cu.data (), r->age.data (), r->type.data (),
+      r->value.data (), r->y2bh.data (), job->pi, job->tier, r->out.data ());
+  else
+    si_index_batch (cells, r->cu.data (), r->age.data (), r->type.data (),
+      r->value.data (), r->est.data (), job->tier, r->out.data ());
+  si_split_codes (cells, r->out.data (), r->code.data (), NAN);
+
+  c = 0;
+  for (i = first; i < first + rows; i++)
+  {
+    job->point[i] = r->out[c];
+    job->code[i] = r->code[c];
+    c++;
+
+    /* the samples with answers, in order */
+    m = 0;
+    sum = 0;
+    for (s = 0; s < job->samples; s++, c++)
+      if (r->code[c] == 0 && !isnan (r->out[c]))
+      {
+        r->kept[m++] = r->out[c];
+        sum += r->out[c];
+      }
+    job->valid[i] = m;
+    if (m == 0)
+    {
+      job->mean[i] = NAN;
+      job->sd[i] = NAN;
+      for (j = 0; j < job->q; j++)
+        job->quantile[(size_t) j * job->n + i] = NAN;
+      continue;
+    }
+
+    job->mean[i] = sum / m;
+    sum = 0;
+    for (s = 0; s < m; s++)
+    {
+      dev = r->kept[s] - job->mean[i];
+      sum += dev * dev;
+    }
+    job->sd[i] = (m > 1) ? sqrt (sum / (m - 1)) : NAN;
+    for (j = 0; j < job->q; j++)
+      job->quantile[(size_t) j * job->n + i] =
+        si_mc_quantile (r->kept.data (), m, job->prob[j]);
+  }
+}
+
+
+static void si_mc_worker (SI_MC_JOB *job)
+{
+  SI_MC_ROWS rows;
+  int b;
+
+
+  while ((b = job->next.fetch_add (1)) * job->rows < job->n)
+    si_mc_block (job, b * job->rows, &rows);
+}
+
+
+/*
+ * Monte Carlo summaries of site index or height for n rows, with samples
+ * draws each.  quantile is n by q, by column.  threads of 0 or less uses
+ * every core.
+ */
+void si_monte_carlo (
+  int n,
+  const int *cu_index,
+  const double *age,
+  const int *age_type,
+  const double *value,
+  const double *y2bh,
+  const double *sd_value,
+  const double *sd_age,
+  int what,
+  int est_type,
+  double pi,
+  int samples,
+  unsigned long long seed,
+  int q,
+  const double *prob,
+  int tier,
+  int threads,
+  double *point,
+  signed char *code,
+  double *mean,
+  double *sd,
+  double *quantile,
+  int *valid)
+{
+  std::vector<std::thread> pool;
+  SI_MC_JOB job;
+  int t, blocks;
+
+
+  job.n = n;
+  job.cu_index = cu_index;
+  job.age = age;
+  job.age_type = age_type;
+  job.value = value;
+  job.y2bh = y2bh;
+  job.sd_value = sd_value;
+  job.sd_age = sd_age;
+  job.what = what;
+  job.est_type = est_type;
+  job.pi = pi;
+  job.samples = samples;
+  job.seed = seed;
+  job.q = q;
+  job.prob = prob;
+  job.tier = tier;
+  job.rows = std::max (1, SI_MC_CELLS / (samples + 1));
+  job.point = point;
+  job.code = code;
+  job.mean = mean;
+  job.sd = sd;
+  job.quantile = quantile;
+  job.valid = valid;
+  job.next = 0;
+
+  blocks = (n + job.rows - 1) / job.rows;
+  if (threads <= 0)
+    threads = (int) std::thread::hardware_concurrency ();
+  threads = std::max (1, std::min (threads, blocks));
+
+  for (t = 1; t < threads; t++)
+    pool.push_back (std::thread (si_mc_worker, &job));
+  si_mc_worker (&job);
+  for (t = 0; t < (int) pool.size (); t++)
+    pool[t].join ();
+}
+
+
+/*
+ * Monte Carlo summaries as a data frame of a row per input row, with
+ * quantiles as a matrix of a column per probability.  With to_height,
+ * value is site index and heights are drawn, otherwise value is height
+ * and site indices are drawn.
+ */
+// [[Rcpp::export]]
+List Sindex_MonteCarlo (
+    IntegerVector cu_index,
+    NumericVector age,
+    IntegerVector age_type,
+    NumericVector value,
+    NumericVector y2bh,
+    NumericVector sd_value,
+    NumericVector sd_age,
+    bool to_height,
+    int est_type,
+    double pi,
+    int samples,
+    NumericVector prob,
+    double seed,
+    int tier = 0,
+    int threads = 0)
+{
+  int n = cu_index.size ();
+  int q = prob.size ();
+  size_t c;
+  int i;
+
+
+  if (age.size () != n || age_type.size () != n || value.size () != n ||
+      sd_value.size () != n || sd_age.size () != n ||
+      (to_height && y2bh.size () != n))
+    stop ("all inputs must have the same length");
+  if (samples < 1)
+    stop ("samples must be at least 1");
+  for (i = 0; i < q; i++)
+    if (!(prob[i] >= 0 && prob[i] <= 1))
+      stop ("probabilities must be between 0 and 1");
+  if (!(seed >= 0 && seed < 18446744073709551616.0))
+    stop ("seed must be a whole number from 0 to 2^64");
+  if (tier < 0 || tier >= SI_MATH_TIERS)
+    stop ("unknown math tier");
+
+  NumericVector point (n);
+  std::vector<signed char> code (n);
+  NumericVector mean (n);
+  NumericVector sd (n);
+  NumericMatrix quantile (n, q);
+  IntegerVector valid (n);
+  si_monte_carlo (n, cu_index.begin (), age.begin (), age_type.begin (),
+    value.begin (), to_height ? y2bh.begin () : NULL, sd_value.begin (),
+    sd_age.begin (), to_height ? SI_MC_HEIGHT : SI_MC_INDEX, est_type, pi,
+    samples, (unsigned long long) seed, q, prob.begin (), tier, threads,
+    point.begin (), code.data (), mean.begin (), sd.begin (),
+    quantile.begin (), valid.begin ());
+
+  /* missing values as R has them */
+  IntegerVector error (n);
+  for (i = 0; i < n; i++)
+  {
+    error[i] = code[i];
+    if (isnan (point[i]))
+      point[i] = NA_REAL;
+    if (isnan (mean[i]))
+      mean[i] = NA_REAL;
+    if (isnan (sd[i]))
+      sd[i] = NA_REAL;
+  }
+  for (c = 0; c < (size_t) n * q; c++)
+    if (isnan (quantile[c]))
+      quantile[c] = NA_REAL;
+
+  return List::create (
+    Named ("summary") = DataFrame::create (
+      Named ("value") = point,
+      Named ("error") = error,
+      Named ("mean") = mean,
+      Named ("sd") = sd,
+      Named ("valid") = valid),
+    Named ("quantile") = quantile);
+}
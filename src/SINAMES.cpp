@@ -155,10 +155,11 @@ using namespace Rcpp;
  * 2017 feb 2  - Added Nigh's 2016 Cwc equation.
  * 2018 jan 10 - Added Nigh's 2017 Pli equation.
  *          18 - Added species codes Ey, Js, Ld, Ls, Oh, Oi, Oj, Ok, Qw.
+ * 2026 oct 18 - Made all tables const.
  */
 
 
-char *si_spec_code[SI_MAX_SPECIES] =
+const char *const si_spec_code[SI_MAX_SPECIES] =
   {
 #ifdef SI_SPEC_A
   "A",
@@ -597,7 +598,7 @@ char *si_spec_code[SI_MAX_SPECIES] =
 #endif
   };
 
-char *si_spec_name[SI_MAX_SPECIES] =
+const char *const si_spec_name[SI_MAX_SPECIES] =
   {
 #ifdef SI_SPEC_A
   "Aspen",
@@ -1036,7 +1037,7 @@ char *si_spec_name[SI_MAX_SPECIES] =
 #endif
   };
 
-char *si_curve_name[SI_MAX_CURVES] =
+const char *const si_curve_name[SI_MAX_CURVES] =
   {
 #ifdef SI_ACB_HUANG
   "Huang, Titus, and Lakusta (1994)",
@@ -1485,7 +1486,7 @@ char *si_curve_name[SI_MAX_CURVES] =
 *
 * Target_SI = coeff_a + coeff_b * Reference_SI
 */
-double si_convert[SI_MAX_CONVERT][4] =
+const double si_convert[SI_MAX_CONVERT][4] =
   {
 #ifdef SI_SPEC_AT
 #ifdef SI_SPEC_SW
@@ -1607,7 +1608,7 @@ double si_convert[SI_MAX_CONVERT][4] =
 *     4: y2bh = fn (si)
 *     8: si = fn (ht, age) growth intercept
 */
-char si_curve_types[SI_MAX_CURVES] =
+const char si_curve_types[SI_MAX_CURVES] =
   {
 #ifdef SI_ACB_HUANG
   5,
@@ -2053,7 +2054,7 @@ char si_curve_types[SI_MAX_CURVES] =
 /*
 * height(m) of breast height (typically 1.3, 1.37, 1.3716
 */
-double si_curve_bh[SI_MAX_CURVES] =
+const double si_curve_bh[SI_MAX_CURVES] =
   {
 #ifdef SI_ACB_HUANG
   1.3,
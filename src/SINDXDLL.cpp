@@ -1,4 +1,6 @@
 #include <Rcpp.h>
+#include <vector>
+#include <mutex>
 #include "sindex.h"
 using namespace Rcpp;
 
@@ -176,6 +178,11 @@ using namespace Rcpp;
                                                   * 2017 feb 2  - v1.51 Added Nigh's 2016 Cwc equation as default.
                                                   * 2018 jan 11 - Added Nigh's 2017 Pli equation.
                                                   *          18 - Added species codes Ey, Js, Ld, Ls, Oh, Oi, Oj, Ok, Qw.
+                                                  * 2026 oct 18 - Made static tables const.
+                                                  *             - Sindex_NextCurve(), Sindex_CurveSource() and
+                                                  *               Sindex_CurveNotes() now use the curve registry.
+                                                  *             - Added Sindex_Catalog(), giving every species and
+                                                  *               curve with its codes, names and links at once.
                                                   */
 
 
@@ -478,7 +485,7 @@ using namespace Rcpp;
 #define SI_ZH_END     SI_ERR_NO_ANS
 
 
-static char *si_curve_notes[SI_MAX_CURVES][2] =
+static const char *const si_curve_notes[SI_MAX_CURVES][2] =
   {
   /* SI_ACB_HUANG */
   "Huang Shongming, Stephen J. Titus and Tom W. Lakusta. 1994. \
@@ -1590,7 +1597,7 @@ Brunswick. The trees ranged in age from 51 to 175 years at breast height and  \
 ranged in site index from 7.2 m to 21.0 m at 50 years breast height age.",
 #endif
 
-static char si_sclist_start[SI_MAX_SPECIES] =
+static const char si_sclist_start[SI_MAX_SPECIES] =
   {
   SI_A_START,
   SI_ABAL_START,
@@ -1740,7 +1747,7 @@ static char si_sclist_start[SI_MAX_SPECIES] =
   };
 
 
-static char si_curve_default[SI_MAX_SPECIES] =
+static const char si_curve_default[SI_MAX_SPECIES] =
   {
   SI_ERR_NO_ANS,          // A
   SI_ERR_NO_ANS,          // ABAL
@@ -1888,7 +1895,7 @@ static char si_curve_default[SI_MAX_SPECIES] =
   SI_ERR_NO_ANS,          // ZH
   };
 
-static char si_curve_intend[SI_MAX_CURVES] =
+static const char si_curve_intend[SI_MAX_CURVES] =
   {
   SI_SPEC_ACB, /* SI_ACB_HUANG */
   SI_SPEC_ACT, /* SI_ACT_THROWER */
@@ -2299,147 +2306,7 @@ short int Sindex_NextCurve (
   if (si_curve_intend[cu_index] != sp_index)
     return SI_ERR_CURVE;
 
-  switch (cu_index)
-  {
-  case SI_ACB_HUANGAC: cu_index = SI_ACB_HUANG; break;
-  case SI_ACB_HUANG: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_ACT_THROWERAC: cu_index = SI_ACT_THROWER; break;
-  case SI_ACT_THROWER: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_AT_NIGH: cu_index = SI_AT_CHEN; break;
-  case SI_AT_CHEN: cu_index = SI_AT_HUANG; break;
-  case SI_AT_HUANG: cu_index = SI_AT_CIESZEWSKI; break;
-  case SI_AT_CIESZEWSKI: cu_index = SI_AT_GOUDIE; break;
-  case SI_AT_GOUDIE: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_BA_NIGHGI: cu_index = SI_BA_NIGH; break;
-  case SI_BA_NIGH: cu_index = SI_BA_KURUCZ82AC; break;
-  case SI_BA_KURUCZ82AC: cu_index = SI_BA_DILUCCA; break;
-  case SI_BA_DILUCCA: cu_index = SI_BA_KURUCZ86; break;
-  case SI_BA_KURUCZ86: cu_index = SI_BA_KURUCZ82; break;
-  case SI_BA_KURUCZ82: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_BL_CHENAC: cu_index = SI_BL_CHEN; break;
-  case SI_BL_CHEN: cu_index = SI_BL_THROWERGI; break;
-  case SI_BL_THROWERGI: cu_index = SI_BL_KURUCZ82; break;
-  case SI_BL_KURUCZ82: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_BP_CURTISAC: cu_index = SI_BP_CURTIS; break;
-  case SI_BP_CURTIS: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_CWC_NIGH: cu_index = SI_CWC_KURUCZAC; break;
-  case SI_CWC_KURUCZAC: cu_index = SI_CWC_KURUCZ; break;
-  case SI_CWC_KURUCZ: cu_index = SI_CWC_BARKER; break;
-  case SI_CWC_BARKER: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_CWI_NIGH: cu_index = SI_CWI_NIGHGI; break;
-  case SI_CWI_NIGHGI: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_DR_NIGH: cu_index = SI_DR_HARRING; break;
-  case SI_DR_HARRING: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_EP_NIGH: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_FDC_BRUCEAC: cu_index = SI_FDC_NIGHTA; break;
-  case SI_FDC_NIGHTA: cu_index = SI_FDC_NIGHGI; break;
-  case SI_FDC_NIGHGI: cu_index = SI_FDC_BRUCE; break;
-  case SI_FDC_BRUCE: cu_index = SI_FDC_COCHRAN; break;
-  case SI_FDC_COCHRAN: cu_index = SI_FDC_KING; break;
-  case SI_FDC_KING: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_FDI_THROWERAC: cu_index = SI_FDI_NIGHGI; break;
-  case SI_FDI_NIGHGI: cu_index = SI_FDI_HUANG_PLA; break;
-  case SI_FDI_HUANG_PLA: cu_index = SI_FDI_HUANG_NAT; break;
-  case SI_FDI_HUANG_NAT: cu_index = SI_FDI_MILNER; break;
-  case SI_FDI_MILNER: cu_index = SI_FDI_THROWER; break;
-  case SI_FDI_THROWER: cu_index = SI_FDI_VDP_MONT; break;
-  case SI_FDI_VDP_MONT: cu_index = SI_FDI_VDP_WASH; break;
-  case SI_FDI_VDP_WASH: cu_index = SI_FDI_MONS_DF; break;
-  case SI_FDI_MONS_DF: cu_index = SI_FDI_MONS_GF; break;
-  case SI_FDI_MONS_GF: cu_index = SI_FDI_MONS_WRC; break;
-  case SI_FDI_MONS_WRC: cu_index = SI_FDI_MONS_WH; break;
-  case SI_FDI_MONS_WH: cu_index = SI_FDI_MONS_SAF; break;
-  case SI_FDI_MONS_SAF: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_HM_MEANSAC: cu_index = SI_HM_MEANS; break;
-  case SI_HM_MEANS: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_HWC_WILEYAC: cu_index = SI_HWC_NIGHGI99; break;
-  case SI_HWC_NIGHGI99: cu_index = SI_HWC_FARR; break;
-  case SI_HWC_FARR: cu_index = SI_HWC_BARKER; break;
-  case SI_HWC_BARKER: cu_index = SI_HWC_WILEY; break;
-  case SI_HWC_WILEY: cu_index = SI_HWC_WILEY_BC; break;
-  case SI_HWC_WILEY_BC: cu_index = SI_HWC_WILEY_MB; break;
-  case SI_HWC_WILEY_MB: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_HWI_NIGH: cu_index = SI_HWI_NIGHGI; break;
-  case SI_HWI_NIGHGI: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_LW_NIGH: cu_index = SI_LW_NIGHGI; break;
-  case SI_LW_NIGHGI: cu_index = SI_LW_MILNER; break;
-  case SI_LW_MILNER: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_PJ_HUANG: cu_index = SI_PJ_HUANGAC; break;
-  case SI_PJ_HUANGAC: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_PL_CHEN: cu_index = SI_PLI_THROWNIGH; break;
-  case SI_PLI_THROWNIGH: cu_index = SI_PLI_NIGH; break;
-  case SI_PLI_NIGH: cu_index = SI_PLI_NIGHTA98; break;
-  case SI_PLI_NIGHTA98: cu_index = SI_PLI_NIGHGI97; break;
-  case SI_PLI_NIGHGI97: cu_index = SI_PLI_HUANG_PLA; break;
-  case SI_PLI_HUANG_PLA: cu_index = SI_PLI_HUANG_NAT; break;
-  case SI_PLI_HUANG_NAT: cu_index = SI_PLI_THROWER; break;
-  case SI_PLI_THROWER: cu_index = SI_PLI_MILNER; break;
-  case SI_PLI_MILNER: cu_index = SI_PLI_CIESZEWSKI; break;
-  case SI_PLI_CIESZEWSKI: cu_index = SI_PLI_GOUDIE_DRY; break;
-  case SI_PLI_GOUDIE_DRY: cu_index = SI_PLI_GOUDIE_WET; break;
-  case SI_PLI_GOUDIE_WET: cu_index = SI_PLI_DEMPSTER; break;
-  case SI_PLI_DEMPSTER: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_PW_CURTISAC: cu_index = SI_PW_CURTIS; break;
-  case SI_PW_CURTIS: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_PY_NIGH: cu_index = SI_PY_NIGHGI; break;
-  case SI_PY_NIGHGI: cu_index = SI_PY_HANNAC; break;
-  case SI_PY_HANNAC: cu_index = SI_PY_MILNER; break;
-  case SI_PY_MILNER: cu_index = SI_PY_HANN; break;
-  case SI_PY_HANN: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_SB_NIGH: cu_index = SI_SB_HUANG; break;
-  case SI_SB_HUANG: cu_index = SI_SB_CIESZEWSKI; break;
-  case SI_SB_CIESZEWSKI: cu_index = SI_SB_KER; break;
-  case SI_SB_KER: cu_index = SI_SB_DEMPSTER; break;
-  case SI_SB_DEMPSTER: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_SE_CHENAC: cu_index = SI_SE_CHEN; break;
-  case SI_SE_CHEN: cu_index = SI_SE_NIGHGI; break;
-  case SI_SE_NIGHGI: cu_index = SI_SE_NIGH; break;
-  case SI_SE_NIGH: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_SS_NIGHGI99: cu_index = SI_SS_NIGH; break;
-  case SI_SS_NIGH: cu_index = SI_SS_GOUDIE; break;
-  case SI_SS_GOUDIE: cu_index = SI_SS_FARR; break;
-  case SI_SS_FARR: cu_index = SI_SS_BARKER; break;
-  case SI_SS_BARKER: cu_index = SI_ERR_NO_ANS; break;
-
-  case SI_SW_GOUDNIGH:     cu_index = SI_SW_HU_GARCIA; break;
-  case SI_SW_HU_GARCIA:    cu_index = SI_SW_NIGHTA; break;
-  case SI_SW_NIGHTA:       cu_index = SI_SW_NIGHGI2004; break;
-  case SI_SW_NIGHGI2004:   cu_index = SI_SW_HUANG_PLA; break;
-  case SI_SW_HUANG_PLA:    cu_index = SI_SW_HUANG_NAT; break;
-  case SI_SW_HUANG_NAT:    cu_index = SI_SW_THROWER; break;
-  case SI_SW_THROWER:      cu_index = SI_SW_CIESZEWSKI; break;
-  case SI_SW_CIESZEWSKI:   cu_index = SI_SW_KER_PLA; break;
-  case SI_SW_KER_PLA:      cu_index = SI_SW_KER_NAT; break;
-  case SI_SW_KER_NAT:      cu_index = SI_SW_GOUDIE_PLAAC; break;
-  case SI_SW_GOUDIE_PLAAC: cu_index = SI_SW_GOUDIE_PLA; break;
-  case SI_SW_GOUDIE_PLA:   cu_index = SI_SW_GOUDIE_NATAC; break;
-  case SI_SW_GOUDIE_NATAC: cu_index = SI_SW_GOUDIE_NAT; break;
-  case SI_SW_GOUDIE_NAT:   cu_index = SI_ERR_NO_ANS; break;
-  }
-
-  return cu_index;
+  return si_curve (cu_index)->next;
 }
 
 
@@ -2536,89 +2403,7 @@ std::string Sindex_CurveSource (short int cu_index)
   if (cu_index < 0 || cu_index >= SI_MAX_CURVES)
     return NULL;
 
-  switch (cu_index)
-  {
-  case SI_BA_NIGH:
-    cu_index = SI_BA_NIGHGI;
-    break;
-
-  case SI_CWI_NIGHGI:
-    cu_index = SI_CWI_NIGH;
-    break;
-
-  case SI_AT_HUANG:
-  case SI_SB_HUANG:
-  case SI_FDI_HUANG_PLA:
-  case SI_FDI_HUANG_NAT:
-  case SI_PLI_HUANG_PLA:
-  case SI_PLI_HUANG_NAT:
-  case SI_SW_HUANG_PLA:
-  case SI_SW_HUANG_NAT:
-    cu_index = SI_ACB_HUANG;
-    break;
-
-  case SI_PLI_CIESZEWSKI:
-  case SI_SB_CIESZEWSKI:
-  case SI_SW_CIESZEWSKI:
-    cu_index = SI_AT_CIESZEWSKI;
-    break;
-
-  case SI_PLI_DEMPSTER:
-  case SI_SB_DEMPSTER:
-  case SI_SW_DEMPSTER:
-    cu_index = SI_AT_GOUDIE;
-    break;
-
-  case SI_SW_KER_PLA:
-  case SI_SW_KER_NAT:
-    cu_index = SI_SB_KER;
-    break;
-
-  case SI_BL_KURUCZ82:
-    cu_index = SI_BA_KURUCZ82;
-    break;
-
-  case SI_HWC_BARKER:
-  case SI_SS_BARKER:
-    cu_index = SI_CWC_BARKER;
-    break;
-
-  case SI_LW_MILNER:
-  case SI_PLI_MILNER:
-  case SI_PY_MILNER:
-    cu_index = SI_FDI_MILNER;
-    break;
-
-  case SI_FDI_VDP_WASH:
-    cu_index = SI_FDI_VDP_MONT;
-    break;
-
-  case SI_FDI_MONS_GF:
-  case SI_FDI_MONS_WRC:
-  case SI_FDI_MONS_WH:
-  case SI_FDI_MONS_SAF:
-    cu_index = SI_FDI_MONS_DF;
-    break;
-
-  case SI_SS_FARR:
-    cu_index = SI_HWC_FARR;
-    break;
-
-  case SI_HWC_WILEY_BC:
-  case SI_HWC_WILEY_MB:
-    cu_index = SI_HWC_WILEY;
-    break;
-
-  case SI_SW_THROWER:
-    cu_index = SI_PLI_THROWER;
-    break;
-
-  case SI_PLI_GOUDIE_WET:
-  case SI_SW_GOUDIE_PLA:
-  case SI_SW_GOUDIE_NAT:
-    cu_index = SI_PLI_GOUDIE_DRY;
-    break;
-  }
+  cu_index = si_curve (cu_index)->source;
   return si_curve_notes[cu_index][0];
 }
 
@@ -2632,57 +2417,131 @@ std::string Sindex_CurveNotes (short int cu_index)
   if (cu_index < 0 || cu_index >= SI_MAX_CURVES)
     return NULL;
 
-  switch (cu_index)
+  cu_index = si_curve (cu_index)->notes;
+  return si_curve_notes[cu_index][1];
+}
+
+
+/*
+ * the codes of every species and curve that Sindex_Catalog() reports,
+ * taken once from the functions above.  Links that are error codes are
+ * kept as NA.
+ */
+typedef struct
   {
-  case SI_BA_NIGH:
-    cu_index = SI_BA_NIGHGI;
-    break;
-
-  case SI_CWI_NIGHGI:
-    cu_index = SI_CWI_NIGH;
-    break;
-
-  case SI_FDI_HUANG_NAT:
-    cu_index = SI_FDI_HUANG_PLA;
-    break;
-
-  case SI_PLI_HUANG_NAT:
-    cu_index = SI_PLI_HUANG_PLA;
-    break;
-
-  case SI_SW_HUANG_NAT:
-    cu_index = SI_SW_HUANG_PLA;
-    break;
-
-  case SI_SW_KER_NAT:
-    cu_index = SI_SW_KER_PLA;
-    break;
-
-  case SI_FDI_VDP_WASH:
-    cu_index = SI_FDI_VDP_MONT;
-    break;
-
-  case SI_FDI_MONS_GF:
-  case SI_FDI_MONS_WRC:
-  case SI_FDI_MONS_WH:
-  case SI_FDI_MONS_SAF:
-    cu_index = SI_FDI_MONS_DF;
-    break;
-
-  case SI_PLI_GOUDIE_WET:
-    cu_index = SI_PLI_GOUDIE_DRY;
-    break;
-
-  case SI_SW_GOUDIE_NAT:
-    cu_index = SI_SW_GOUDIE_PLA;
-    break;
-
-  case SI_PY_NIGHGI:
-    cu_index = SI_PY_NIGH;
-    break;
+  std::vector<int> sp_use;
+  std::vector<int> sp_default;
+  std::vector<int> sp_default_gi;
+  std::vector<int> sp_first;
+  std::vector<int> cu_species;
+  std::vector<int> cu_types;
+  std::vector<int> cu_next;
+  std::vector<int> cu_default;
+  } SI_CATALOG;
+
+static SI_CATALOG si_catalog;
+static std::once_flag si_catalog_once;
+
+
+static int si_catalog_link (int x)
+{
+  return (x < 0) ? NA_INTEGER : x;
+}
+
+
+static void si_catalog_build (void)
+{
+  SI_CATALOG *c = &si_catalog;
+  short int sp, cu;
+
+
+  for (sp = 0; sp < SI_MAX_SPECIES; sp++)
+  {
+    c->sp_use.push_back (Sindex_SpecUse (sp));
+    c->sp_default.push_back (si_catalog_link (Sindex_DefCurve (sp)));
+    c->sp_default_gi.push_back (si_catalog_link (Sindex_DefGICurve (sp)));
+    c->sp_first.push_back (si_catalog_link (Sindex_FirstCurve (sp)));
   }
 
-  return si_curve_notes[cu_index][1];
+  for (cu = 0; cu < SI_MAX_CURVES; cu++)
+  {
+    sp = si_curve_intend[cu];
+    c->cu_species.push_back (sp);
+    c->cu_types.push_back (si_curve_types[cu]);
+    c->cu_next.push_back (si_catalog_link (si_curve (cu)->next));
+    c->cu_default.push_back (si_curve_default[sp] == cu);
+  }
+}
+
+
+/*
+ * every species and every curve, as the enumerating functions give them,
+ * in two data frames: species and curves.
+ */
+// [[Rcpp::export]]
+List Sindex_Catalog ()
+{
+  const SI_CATALOG *c = &si_catalog;
+  int i;
+
+
+  std::call_once (si_catalog_once, si_catalog_build);
+
+  IntegerVector sp_index (SI_MAX_SPECIES);
+  CharacterVector sp_code (SI_MAX_SPECIES);
+  CharacterVector sp_name (SI_MAX_SPECIES);
+  for (i = 0; i < SI_MAX_SPECIES; i++)
+  {
+    sp_index[i] = i;
+    sp_code[i] = si_spec_code[i];
+    sp_name[i] = si_spec_name[i];
+  }
+
+  IntegerVector cu_index (SI_MAX_CURVES);
+  CharacterVector cu_name (SI_MAX_CURVES);
+  CharacterVector cu_code (SI_MAX_CURVES);
+  CharacterVector cu_source (SI_MAX_CURVES);
+  CharacterVector cu_notes (SI_MAX_CURVES);
+  for (i = 0; i < SI_MAX_CURVES; i++)
+  {
+    cu_index[i] = i;
+    cu_name[i] = si_curve_name[i];
+    cu_code[i] = si_spec_code[c->cu_species[i]];
+    cu_source[i] = si_curve_notes[si_curve ((short int) i)->source][0];
+    cu_notes[i] = si_curve_notes[si_curve ((short int) i)->notes][1];
+  }
+
+  DataFrame species = DataFrame::create (
+    Named ("species") = sp_index,
+    Named ("code") = sp_code,
+    Named ("name") = sp_name,
+    Named ("use") = IntegerVector (c->sp_use.begin (), c->sp_use.end ()),
+    Named ("default_curve") = IntegerVector (c->sp_default.begin (),
+      c->sp_default.end ()),
+    Named ("default_gi_curve") = IntegerVector (c->sp_default_gi.begin (),
+      c->sp_default_gi.end ()),
+    Named ("first_curve") = IntegerVector (c->sp_first.begin (),
+      c->sp_first.end ()),
+    Named ("stringsAsFactors") = false);
+
+  DataFrame curves = DataFrame::create (
+    Named ("curve") = cu_index,
+    Named ("name") = cu_name,
+    Named ("species") = IntegerVector (c->cu_species.begin (),
+      c->cu_species.end ()),
+    Named ("code") = cu_code,
+    Named ("use") = IntegerVector (c->cu_types.begin (), c->cu_types.end ()),
+    Named ("next_curve") = IntegerVector (c->cu_next.begin (),
+      c->cu_next.end ()),
+    Named ("default") = LogicalVector (c->cu_default.begin (),
+      c->cu_default.end ()),
+    Named ("source") = cu_source,
+    Named ("notes") = cu_notes,
+    Named ("stringsAsFactors") = false);
+
+  return List::create (
+    Named ("species") = species,
+    Named ("curves") = curves);
 }
 
 
@@ -0,0 +1,235 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * sistress.c
+ * - stress test of the engine from many threads.  Callers on several
+ *   threads make the same calls over and over: the scalar entry points
+ *   on a grid of every curve, and the batch functions, including the
+ *   yield table and Monte Carlo, which start threads of their own.
+ *   Meanwhile the calling thread turns telemetry and tracing on and off
+ *   and reads the counts and the trace records.
+ * - every answer is compared with one made beforehand on one thread,
+ *   with telemetry and tracing off.  Answers that differ are counted.
+ * - built with -fsanitize=thread, ThreadSanitizer reports any data race
+ *   the calls run into.
+ *
+ * 2026 oct 18 - Created.
+ *             - Reads the trace records while the callers run.
+ */
+
+
+/* as defined in sitelem.c and sitrace.c */
+List Sindex_Telemetry (bool);
+DataFrame Sindex_Trace (bool);
+
+/* a grid point: curve, age type, age and site index */
+typedef struct
+  {
+  int    cu_index;
+  int    age_type;
+  double age;
+  double si;
+  } SI_STRESS_ROW;
+
+static const double si_stress_age[] = { 5, 25, 60, 120 };
+static const double si_stress_si[] = { 12, 30 };
+static const double si_stress_prob[] = { 0.05, 0.5, 0.95 };
+
+/* what the callers share */
+typedef struct
+  {
+  const std::vector<SI_STRESS_ROW> *grid;
+  const std::vector<double> *want;   /* answers from one thread */
+  int rounds;
+  std::atomic<int> running;          /* callers not yet done */
+  std::atomic<long> differ;          /* answers not as wanted */
+  } SI_STRESS_JOB;
+
+
+/* the grid, every known curve */
+static void si_stress_grid (std::vector<SI_STRESS_ROW> &grid)
+{
+  SI_STRESS_ROW r;
+  int c, t, a, s;
+
+
+  for (c = 0; c < SI_MAX_CURVES; c++)
+  {
+    if (si_curve ((short int) c) == NULL)
+      continue;
+    for (t = SI_AT_TOTAL; t <= SI_AT_BREAST; t++)
+      for (a = 0; a < 4; a++)
+        for (s = 0; s < 2; s++)
+        {
+          r.cu_index = c;
+          r.age_type = t;
+          r.age = si_stress_age[a];
+          r.si = si_stress_si[s];
+          grid.push_back (r);
+        }
+  }
+}
+
+
+/* one round of calls, every answer in order into out */
+static void si_stress_round (
+  const std::vector<SI_STRESS_ROW> &grid,
+  std::vector<double> &out)
+{
+  int n = (int) grid.size ();
+  std::vector<int> cu (n), type (n), est (n);
+  std::vector<double> age (n), si (n), y2bh (n), ht (n), sd_ht (n), sd_age (n);
+  std::vector<double> res (n), d_site (n), d_age (n);
+  std::vector<signed char> code (n);
+  std::vector<int> valid (n);
+  std::vector<double> ages;
+  const SI_STRESS_ROW *r;
+  short int c;
+  double h, y;
+  int i, k, m;
+
+
+  out.clear ();
+
+  /* the scalar entry points */
+  for (i = 0; i < n; i++)
+  {
+    r = &grid[i];
+    c = (short int) r->cu_index;
+    y = si_y2bh (c, r->si);
+    h = index_to_height (c, r->age, (short int) r->age_type, r->si, y, 0.5);
+    out.push_back (y);
+    out.push_back (h);
+    out.push_back (height_to_index (c, r->age, (short int) r->age_type, 15,
+      SI_EST_DIRECT));
+    out.push_back (height_to_index (c, r->age, (short int) r->age_type, 15,
+      SI_EST_ITERATE));
+    out.push_back (height_to_index (c, r->age, (short int) r->age_type, 15,
+      SI_EST_APPROX));
+    out.push_back (index_to_age (c, 15, (short int) r->age_type, r->si, y));
+    out.push_back (age_to_age (c, r->age, (short int) r->age_type,
+      (short int) (SI_AT_TOTAL + SI_AT_BREAST - r->age_type), y));
+
+    cu[i] = r->cu_index;
+    type[i] = r->age_type;
+    est[i] = SI_EST_ITERATE;
+    age[i] = r->age;
+    si[i] = r->si;
+    y2bh[i] = y;
+    ht[i] = 15;
+    sd_ht[i] = 0.3;
+    sd_age[i] = 2;
+  }
+
+  /* the batch functions */
+  si_height_batch (n, cu.data (), age.data (), type.data (), si.data (),
+    y2bh.data (), 0.5, 0, res.data ());
+  out.insert (out.end (), res.begin (), res.end ());
+  si_index_batch (n, cu.data (), age.data (), type.data (), ht.data (),
+    est.data (), 0, res.data ());
+  out.insert (out.end (), res.begin (), res.end ());
+  si_increment_batch (n, cu.data (), age.data (), type.data (), si.data (),
+    y2bh.data (), 0.5, 1, 0, res.data (), d_site.data (), d_age.data ());
+  out.insert (out.end (), res.begin (), res.end ());
+  out.insert (out.end (), d_site.begin (), d_site.end ());
+  out.insert (out.end (), d_age.begin (), d_age.end ());
+
+  /* the threaded ones, with threads of their own */
+  for (k = 0; k <= 100; k += 10)
+    ages.push_back (k);
+  m = (int) ages.size ();
+  std::vector<double> table ((size_t) n * m), total ((size_t) n * m),
+    breast ((size_t) n * m);
+  si_yield_table (n, cu.data (), si.data (), y2bh.data (), m, ages.data (),
+    NULL, SI_AT_TOTAL, 0.5, 0, 2, table.data (), total.data (),
+    breast.data ());
+  out.insert (out.end (), table.begin (), table.end ());
+
+  std::vector<double> mean (n), sd (n), quantile ((size_t) n * 3);
+  si_monte_carlo (n, cu.data (), age.data (), type.data (), ht.data (), NULL,
+    sd_ht.data (), sd_age.data (), SI_MC_INDEX, SI_EST_ITERATE, 0.5, 64, 1,
+    3, si_stress_prob, 0, 2, res.data (), code.data (), mean.data (),
+    sd.data (), quantile.data (), valid.data ());
+  out.insert (out.end (), mean.begin (), mean.end ());
+  out.insert (out.end (), quantile.begin (), quantile.end ());
+}
+
+
+/* a caller, making every round of calls and checking its answers */
+static void si_stress_caller (SI_STRESS_JOB *job)
+{
+  std::vector<double> got;
+  const std::vector<double> &want = *job->want;
+  size_t i;
+  int r;
+
+
+  for (r = 0; r < job->rounds; r++)
+  {
+    si_stress_round (*job->grid, got);
+    for (i = 0; i < want.size (); i++)
+      if (!(got[i] == want[i] || (isnan (got[i]) && isnan (want[i]))))
+        job->differ.fetch_add (1, std::memory_order_relaxed);
+  }
+  job->running.fetch_sub (1);
+}
+
+
+/*
+ * runs rounds rounds of calls on each of threads threads, while turning
+ * telemetry and tracing on and off.  Returns the number of answers that
+ * differ from those made on one thread.  Telemetry and tracing are left
+ * as they were; counts and records made meanwhile are kept.
+ */
+// [[Rcpp::export]]
+int Sindex_StressTest (int rounds, int threads)
+{
+  std::vector<SI_STRESS_ROW> grid;
+  std::vector<double> want;
+  std::vector<std::thread> pool;
+  SI_STRESS_JOB job;
+  int telemetry, trace, k;
+
+
+  if (rounds < 1 || threads < 1)
+    stop ("rounds and threads must be positive");
+
+  si_stress_grid (grid);
+  telemetry = si_telemetry.exchange (0);
+  trace = si_trace.exchange (0);
+  si_stress_round (grid, want);
+
+  job.grid = &grid;
+  job.want = &want;
+  job.rounds = rounds;
+  job.running.store (threads);
+  job.differ.store (0);
+  for (k = 0; k < threads; k++)
+    pool.push_back (std::thread (si_stress_caller, &job));
+
+  /* switch counting and tracing while the callers run */
+  for (k = 0; job.running.load () > 0; k++)
+  {
+    si_telemetry.store (k & 1, std::memory_order_relaxed);
+    si_trace.store ((k & 2) ? 2 : 0, std::memory_order_relaxed);
+    if (k % 8 == 0)
+      Sindex_Telemetry (false);
+    if (k % 8 == 4)
+      Sindex_Trace (false);
+    std::this_thread::sleep_for (std::chrono::milliseconds (1));
+  }
+  for (k = 0; k < threads; k++)
+    pool[k].join ();
+
+  si_telemetry.store (telemetry);
+  si_trace.store (trace);
+  return (int) job.differ.load ();
+}
@@ -0,0 +1,355 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <memory>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * sitelem.c
+ * - solver telemetry: counts of the solves made by site_iterate(),
+ *   iterate(), gi_iterate(), gi_si2ht(), hu_garcia_q(), total_iterate(),
+ *   si_fit_plots(), by curve and solver.  For each there are calls, steps, a
+ *   histogram of steps per solve, how the solves ended, and the error
+ *   codes returned.
+ * - counting is off until turned on with Sindex_TelemetryOn().  Each
+ *   thread counts in its own block, allocated on its first counted solve,
+ *   so solves never wait on each other.  Only the owning thread writes a
+ *   block, with plain loads and stores.
+ * - Sindex_Telemetry() sums all blocks when asked, with the counts of
+ *   threads that have ended.  Counts of solves still running on other
+ *   threads may be a step behind.
+ *
+ * 2026 oct 18 - Created.
+ *             - Added si_fit_plots().
+ *             - Made si_telemetry atomic.
+ */
+
+
+/* steps per solve: 1, 2, 3-4, 5-8, ..., 257-512, more */
+#define SI_TELEM_BINS  11
+
+/* error codes counted, SI_ERR_LT13 to SI_ERR_ESTAB */
+#define SI_TELEM_CODES 12
+
+typedef std::atomic<unsigned long> SI_TELEM_N;
+
+typedef struct
+  {
+  SI_TELEM_N calls;
+  SI_TELEM_N steps;
+  SI_TELEM_N most;                    /* most steps of any one solve */
+  SI_TELEM_N hist[SI_TELEM_BINS];
+  SI_TELEM_N ends[SI_ENDS];
+  SI_TELEM_N codes[SI_TELEM_CODES];   /* codes[0] for SI_ERR_LT13 */
+  } SI_TELEM_COUNT;
+
+/* one thread's counts; row SI_MAX_CURVES is for unknown curves */
+typedef struct
+  {
+  SI_TELEM_COUNT count[SI_MAX_CURVES + 1][SI_SOLVERS];
+  } SI_TELEM;
+
+
+class si_telem_thread
+{
+public:
+  SI_TELEM *t;
+  si_telem_thread ();
+  ~si_telem_thread ();
+};
+
+
+std::atomic<int> si_telemetry (0);
+
+static std::mutex si_telem_lock;
+static std::vector<SI_TELEM *> si_telem_live;   /* blocks of running threads */
+static SI_TELEM si_telem_ended;                 /* sums of ended threads */
+static thread_local si_telem_thread si_telem_own;
+
+static const char *si_telem_solver[SI_SOLVERS] =
+  {
+  "site_iterate", "iterate", "gi_iterate", "gi_si2ht", "hu_garcia_q",
+  "total_iterate", "si_fit_plots"
+  };
+
+static const char *si_telem_code[SI_TELEM_CODES] =
+  {
+  "SI_ERR_LT13", "SI_ERR_GI_MIN", "SI_ERR_GI_MAX", "SI_ERR_NO_ANS",
+  "SI_ERR_CURVE", "SI_ERR_CLASS", "SI_ERR_FIZ", "SI_ERR_CODE",
+  "SI_ERR_GI_TOT", "SI_ERR_SPEC", "SI_ERR_AGE_TYPE", "SI_ERR_ESTAB"
+  };
+
+
+/* adds to a counter of the calling thread's own block */
+static inline void si_telem_add (SI_TELEM_N &c, unsigned long n)
+{
+  c.store (c.load (std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+
+/* adds all of one block into another */
+static void si_telem_sum (SI_TELEM *to, const SI_TELEM *from)
+{
+  const SI_TELEM_COUNT *f;
+  SI_TELEM_COUNT *t;
+  int c, s, k;
+  unsigned long most;
+
+
+  for (c = 0; c <= SI_MAX_CURVES; c++)
+    for (s = 0; s < SI_SOLVERS; s++)
+    {
+      f = &from->count[c][s];
+      t = &to->count[c][s];
+      si_telem_add (t->calls, f->calls.load (std::memory_order_relaxed));
+      si_telem_add (t->steps, f->steps.load (std::memory_order_relaxed));
+      most = f->most.load (std::memory_order_relaxed);
+      if (most > t->most.load (std::memory_order_relaxed))
+        t->most.store (most, std::memory_order_relaxed);
+      for (k = 0; k < SI_TELEM_BINS; k++)
+        si_telem_add (t->hist[k], f->hist[k].load (std::memory_order_relaxed));
+      for (k = 0; k < SI_ENDS; k++)
+        si_telem_add (t->ends[k], f->ends[k].load (std::memory_order_relaxed));
+      for (k = 0; k < SI_TELEM_CODES; k++)
+        si_telem_add (t->codes[k], f->codes[k].load (std::memory_order_relaxed));
+    }
+}
+
+
+static void si_telem_zero (SI_TELEM *t)
+{
+  SI_TELEM_COUNT *n;
+  int c, s, k;
+
+
+  for (c = 0; c <= SI_MAX_CURVES; c++)
+    for (s = 0; s < SI_SOLVERS; s++)
+    {
+      n = &t->count[c][s];
+      n->calls.store (0, std::memory_order_relaxed);
+      n->steps.store (0, std::memory_order_relaxed);
+      n->most.store (0, std::memory_order_relaxed);
+      for (k = 0; k < SI_TELEM_BINS; k++)
+        n->hist[k].store (0, std::memory_order_relaxed);
+      for (k = 0; k < SI_ENDS; k++)
+        n->ends[k].store (0, std::memory_order_relaxed);
+      for (k = 0; k < SI_TELEM_CODES; k++)
+        n->codes[k].store (0, std::memory_order_relaxed);
+    }
+}
+
+
+si_telem_thread::si_telem_thread ()
+{
+  t = new SI_TELEM ();
+  std::lock_guard<std::mutex> hold (si_telem_lock);
+  si_telem_live.push_back (t);
+}
+
+
+/* a thread's counts outlive it, in si_telem_ended */
+si_telem_thread::~si_telem_thread ()
+{
+  std::lock_guard<std::mutex> hold (si_telem_lock);
+  si_telem_sum (&si_telem_ended, t);
+  si_telem_live.erase (std::find (si_telem_live.begin (), si_telem_live.end (), t));
+  delete t;
+}
+
+
+/*
+ * counts one solve.  Called by the solvers when si_telemetry is set.
+ */
+void si_telemetry_solve (
+  short int solver,
+  short int cu_index,
+  short int end,
+  double result,
+  int steps)
+{
+  SI_TELEM_COUNT *n;
+  int bin, code;
+
+
+  if (cu_index < 0 || cu_index >= SI_MAX_CURVES)
+    cu_index = SI_MAX_CURVES;
+  n = &si_telem_own.t->count[cu_index][solver];
+
+  if (steps < 0)
+    steps = 0;
+  for (bin = 0; bin < SI_TELEM_BINS - 1 && steps > (1 << bin); bin++)
+    ;
+
+  si_telem_add (n->calls, 1);
+  si_telem_add (n->steps, (unsigned long) steps);
+  if ((unsigned long) steps > n->most.load (std::memory_order_relaxed))
+    n->most.store ((unsigned long) steps, std::memory_order_relaxed);
+  si_telem_add (n->hist[bin], 1);
+  si_telem_add (n->ends[end], 1);
+
+  if (result < 0 && result == (int) result)
+  {
+    code = -(int) result;
+    if (code >= 1 && code <= SI_TELEM_CODES)
+      si_telem_add (n->codes[code - 1], 1);
+  }
+}
+
+
+/*
+ * turns counting on (1) or off (0), or leaves it (-1).  Returns the
+ * previous setting.
+ */
+// [[Rcpp::export]]
+bool Sindex_TelemetryOn (int on)
+{
+  int was;
+
+
+  if (on >= 0)
+    was = si_telemetry.exchange (on != 0, std::memory_order_relaxed);
+  else
+    was = si_telemetry.load (std::memory_order_relaxed);
+  return was != 0;
+}
+
+
+/*
+ * the counts of all threads so far, as three data frames, each keyed by
+ * curve and solver: solves, one row per curve and solver used; histogram,
+ * one row per bin of the steps histogram that has solves; and codes, one
+ * row per error code returned.  Counts are zeroed after reading if reset
+ * is set.
+ */
+// [[Rcpp::export]]
+List Sindex_Telemetry (bool reset)
+{
+  std::unique_ptr<SI_TELEM> total (new SI_TELEM ());
+  const SI_TELEM_COUNT *n;
+  const SI_CURVE *cu;
+  size_t i;
+  int c, s, k;
+  unsigned long v;
+
+
+  {
+    std::lock_guard<std::mutex> hold (si_telem_lock);
+    si_telem_sum (total.get (), &si_telem_ended);
+    for (i = 0; i < si_telem_live.size (); i++)
+      si_telem_sum (total.get (), si_telem_live[i]);
+    if (reset)
+    {
+      si_telem_zero (&si_telem_ended);
+      for (i = 0; i < si_telem_live.size (); i++)
+        si_telem_zero (si_telem_live[i]);
+    }
+  }
+
+  std::vector<int> s_curve, s_solver, h_curve, h_solver, h_upto, e_curve, e_solver, e_code;
+  std::vector<double> s_calls, s_steps, s_most, s_ends[SI_ENDS], h_count, e_count;
+
+  for (c = 0; c <= SI_MAX_CURVES; c++)
+    for (s = 0; s < SI_SOLVERS; s++)
+    {
+      n = &total->count[c][s];
+      if (n->calls.load (std::memory_order_relaxed) == 0)
+        continue;
+
+      s_curve.push_back (c);
+      s_solver.push_back (s);
+      s_calls.push_back ((double) n->calls.load (std::memory_order_relaxed));
+      s_steps.push_back ((double) n->steps.load (std::memory_order_relaxed));
+      s_most.push_back ((double) n->most.load (std::memory_order_relaxed));
+      for (k = 0; k < SI_ENDS; k++)
+        s_ends[k].push_back ((double) n->ends[k].load (std::memory_order_relaxed));
+
+      for (k = 0; k < SI_TELEM_BINS; k++)
+        if ((v = n->hist[k].load (std::memory_order_relaxed)) > 0)
+        {
+          h_curve.push_back (c);
+          h_solver.push_back (s);
+          h_upto.push_back ((k < SI_TELEM_BINS - 1) ? 1 << k : NA_INTEGER);
+          h_count.push_back ((double) v);
+        }
+
+      for (k = 0; k < SI_TELEM_CODES; k++)
+        if ((v = n->codes[k].load (std::memory_order_relaxed)) > 0)
+        {
+          e_curve.push_back (c);
+          e_solver.push_back (s);
+          e_code.push_back (k);
+          e_count.push_back ((double) v);
+        }
+    }
+
+  IntegerVector out_curve (s_curve.size ());
+  CharacterVector out_name (s_curve.size ());
+  CharacterVector out_solver (s_curve.size ());
+  for (i = 0; i < s_curve.size (); i++)
+  {
+    cu = (s_curve[i] < SI_MAX_CURVES) ? si_curve ((short int) s_curve[i]) : NULL;
+    out_curve[i] = (cu != NULL) ? s_curve[i] : NA_INTEGER;
+    out_name[i] = (cu != NULL) ? cu->name : "unknown";
+    out_solver[i] = si_telem_solver[s_solver[i]];
+  }
+
+  IntegerVector hist_curve (h_curve.size ());
+  CharacterVector hist_name (h_curve.size ());
+  CharacterVector hist_solver (h_curve.size ());
+  for (i = 0; i < h_curve.size (); i++)
+  {
+    cu = (h_curve[i] < SI_MAX_CURVES) ? si_curve ((short int) h_curve[i]) : NULL;
+    hist_curve[i] = (cu != NULL) ? h_curve[i] : NA_INTEGER;
+    hist_name[i] = (cu != NULL) ? cu->name : "unknown";
+    hist_solver[i] = si_telem_solver[h_solver[i]];
+  }
+
+  IntegerVector code_curve (e_curve.size ());
+  CharacterVector code_name (e_curve.size ());
+  CharacterVector code_solver (e_curve.size ());
+  IntegerVector code_value (e_curve.size ());
+  CharacterVector code_label (e_curve.size ());
+  for (i = 0; i < e_curve.size (); i++)
+  {
+    cu = (e_curve[i] < SI_MAX_CURVES) ? si_curve ((short int) e_curve[i]) : NULL;
+    code_curve[i] = (cu != NULL) ? e_curve[i] : NA_INTEGER;
+    code_name[i] = (cu != NULL) ? cu->name : "unknown";
+    code_solver[i] = si_telem_solver[e_solver[i]];
+    code_value[i] = -(e_code[i] + 1);
+    code_label[i] = si_telem_code[e_code[i]];
+  }
+
+  return List::create (
+    Named ("solves") = DataFrame::create (
+      Named ("curve") = out_curve,
+      Named ("name") = out_name,
+      Named ("solver") = out_solver,
+      Named ("calls") = wrap (s_calls),
+      Named ("steps") = wrap (s_steps),
+      Named ("max_steps") = wrap (s_most),
+      Named ("converged") = wrap (s_ends[SI_END_CONVERGED]),
+      Named ("step_exits") = wrap (s_ends[SI_END_STEP]),
+      Named ("limit_exits") = wrap (s_ends[SI_END_LIMIT]),
+      Named ("error_exits") = wrap (s_ends[SI_END_ERROR]),
+      Named ("stringsAsFactors") = false),
+    Named ("histogram") = DataFrame::create (
+      Named ("curve") = hist_curve,
+      Named ("name") = hist_name,
+      Named ("solver") = hist_solver,
+      Named ("steps_upto") = wrap (h_upto),
+      Named ("count") = wrap (h_count),
+      Named ("stringsAsFactors") = false),
+    Named ("codes") = DataFrame::create (
+      Named ("curve") = code_curve,
+      Named ("name") = code_name,
+      Named ("solver") = code_solver,
+      Named ("code") = code_value,
+      Named ("error") = code_label,
+      Named ("count") = wrap (e_count),
+      Named ("stringsAsFactors") = false));
+}
@@ -0,0 +1,286 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <unordered_map>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * sitopht.c
+ * - top height of tree lists, and site index from it: for each plot and
+ *   species, the largest diameter trees up to a number of stems/ha, 100
+ *   by convention, with their mean height and age weighted by the stems
+ *   each stands for.
+ * - trees are put together by plot and species with one counting pass,
+ *   and each group's top trees found by weighted selection, partitioning
+ *   about a diameter until the stems above it reach the top.  Trees are
+ *   never fully sorted.  The last tree taken may count in part, so the
+ *   top is exact; groups with fewer stems use all their trees.
+ * - site indices of all groups are then found by si_index_batch(), with
+ *   the curve of each group's trees.
+ *
+ * 2026 oct 18 - Created.
+ *             - Group keys are built unsigned, so negative and NA plots
+ *               are grouped without undefined shifts.
+ */
+
+
+/* a tree with what selection needs */
+typedef struct
+  {
+  double dbh;
+  double height;
+  double age;
+  double stems;   /* stems/ha the tree stands for */
+  int    row;
+  } SI_TOP_TREE;
+
+
+static inline void si_top_swap (SI_TOP_TREE *a, SI_TOP_TREE *b)
+{
+  SI_TOP_TREE t;
+
+
+  t = *a;
+  *a = *b;
+  *b = t;
+}
+
+
+/*
+ * moves the largest diameter trees of t[0..m) holding top stems/ha to the
+ * front, in no order.  Returns how many; part gets the share of the last
+ * one's stems counted, which is 1 unless the top falls within it.
+ */
+static int si_top_select (
+  SI_TOP_TREE *t,
+  int m,
+  double top,
+  double *part)
+{
+  int lo, hi, gt, eq, i;
+  double pivot, need, w_gt, w_eq;
+
+
+  lo = 0;
+  hi = m;
+  need = top;
+  *part = 1;
+  while (lo < hi)
+  {
+    /* median of three for the pivot */
+    pivot = t[lo + (hi - lo) / 2].dbh;
+    if ((t[lo].dbh > pivot) != (t[lo].dbh > t[hi - 1].dbh))
+      pivot = t[lo].dbh;
+    else if ((t[hi - 1].dbh > pivot) != (t[hi - 1].dbh > t[lo].dbh))
+      pivot = t[hi - 1].dbh;
+
+    /* t[lo..gt) above the pivot, t[gt..eq) at it, t[eq..hi) below */
+    gt = lo;
+    eq = lo;
+    w_gt = 0;
+    w_eq = 0;
+    for (i = lo; i < hi; i++)
+    {
+      if (t[i].dbh > pivot)
+      {
+        w_gt += t[i].stems;
+        si_top_swap (&t[i], &t[eq]);
+        si_top_swap (&t[eq], &t[gt]);
+        gt++;
+        eq++;
+      }
+      else if (t[i].dbh == pivot)
+      {
+        w_eq += t[i].stems;
+        si_top_swap (&t[i], &t[eq]);
+        eq++;
+      }
+    }
+
+    if (w_gt >= need)
+      hi = gt;
+    else if (w_gt + w_eq >= need)
+    {
+      /* the top falls among trees of the pivot's diameter */
+      need -= w_gt;
+      for (i = gt; i < eq - 1 && t[i].stems < need; i++)
+        need -= t[i].stems;
+      *part = need / t[i].stems;
+      return i + 1;
+    }
+    else
+    {
+      need -= w_gt + w_eq;
+      lo = eq;
+    }
+  }
+
+  /* all the trees, or the top fell just after those above a pivot */
+  return hi;
+}
+
+
+/*
+ * top height and site index for each plot and species of a tree list,
+ * in order of their first tree.  Trees with missing values, or no stems,
+ * are left out.  share is the share of each tree's stems in its top.
+ */
+// [[Rcpp::export]]
+List Sindex_TopHeight (
+    IntegerVector plot,
+    IntegerVector species,
+    IntegerVector cu_index,
+    NumericVector dbh,
+    NumericVector height,
+    NumericVector age,
+    NumericVector stems,
+    int age_type,
+    int est_type,
+    double top = 100,
+    int tier = 0)
+{
+  int n = plot.size ();
+  std::unordered_map<unsigned long long, int> key;
+  std::vector<int> group (n, -1);
+  std::vector<int> first;
+  std::vector<int> start;
+  std::vector<SI_TOP_TREE> tree;
+  SI_TOP_TREE *t;
+  unsigned long long k;
+  int i, g, m, c, groups;
+  double part, w, sum_w, sum_h, sum_a;
+
+
+  if (species.size () != n || cu_index.size () != n || dbh.size () != n ||
+      height.size () != n || age.size () != n || stems.size () != n)
+    stop ("all inputs must have the same length");
+  if (!(top > 0))
+    stop ("top must be positive");
+  if (tier < 0 || tier >= SI_MATH_TIERS)
+    stop ("unknown math tier");
+
+  /* groups in order of their first tree */
+  for (i = 0; i < n; i++)
+  {
+    /* unsigned, as a negative or NA plot may not be shifted */
+    k = ((unsigned long long) (unsigned int) plot[i] << 32) |
+      (unsigned int) species[i];
+    auto at = key.find (k);
+    if (at == key.end ())
+    {
+      g = (int) first.size ();
+      key[k] = g;
+      first.push_back (i);
+    }
+    else
+      g = at->second;
+    if (cu_index[i] != cu_index[first[g]])
+      stop ("each plot and species must have one curve");
+    if (!isnan (dbh[i]) && !isnan (height[i]) && !isnan (age[i]) &&
+        stems[i] > 0)
+      group[i] = g;
+  }
+  groups = (int) first.size ();
+
+  /* each group's trees together */
+  start.assign (groups + 1, 0);
+  for (i = 0; i < n; i++)
+    if (group[i] >= 0)
+      start[group[i] + 1]++;
+  for (g = 0; g < groups; g++)
+    start[g + 1] += start[g];
+  tree.resize (start[groups]);
+  std::vector<int> next (start.begin (), start.end () - 1);
+  for (i = 0; i < n; i++)
+    if (group[i] >= 0)
+    {
+      t = &tree[next[group[i]]++];
+      t->dbh = dbh[i];
+      t->height = height[i];
+      t->age = age[i];
+      t->stems = stems[i];
+      t->row = i;
+    }
+
+  IntegerVector out_plot (groups);
+  IntegerVector out_species (groups);
+  IntegerVector out_curve (groups);
+  IntegerVector out_trees (groups);
+  NumericVector out_stems (groups);
+  NumericVector out_height (groups);
+  NumericVector out_age (groups);
+  NumericVector share (n);
+  std::vector<int> si_cu, si_type, si_est, si_group;
+  std::vector<double> si_age, si_height;
+
+  for (g = 0; g < groups; g++)
+  {
+    out_plot[g] = plot[first[g]];
+    out_species[g] = species[first[g]];
+    out_curve[g] = cu_index[first[g]];
+
+    m = start[g + 1] - start[g];
+    if (m == 0)
+    {
+      out_stems[g] = 0;
+      out_height[g] = NA_REAL;
+      out_age[g] = NA_REAL;
+      continue;
+    }
+
+    t = &tree[start[g]];
+    c = si_top_select (t, m, top, &part);
+    sum_w = 0;
+    sum_h = 0;
+    sum_a = 0;
+    for (i = 0; i < c; i++)
+    {
+      w = (i == c - 1) ? t[i].stems * part : t[i].stems;
+      sum_w += w;
+      sum_h += w * t[i].height;
+      sum_a += w * t[i].age;
+      share[t[i].row] = w / t[i].stems;
+    }
+    out_trees[g] = c;
+    out_stems[g] = sum_w;
+    out_height[g] = sum_h / sum_w;
+    out_age[g] = sum_a / sum_w;
+
+    si_group.push_back (g);
+    si_cu.push_back (out_curve[g]);
+    si_age.push_back (out_age[g]);
+    si_type.push_back (age_type);
+    si_height.push_back (out_height[g]);
+    si_est.push_back (est_type);
+  }
+
+  /* site index of every group with trees at once */
+  NumericVector out_site (groups, NA_REAL);
+  IntegerVector out_error (groups, NA_INTEGER);
+  m = (int) si_group.size ();
+  std::vector<double> site (m);
+  std::vector<signed char> code (m);
+  si_index_batch (m, si_cu.data (), si_age.data (), si_type.data (),
+    si_height.data (), si_est.data (), tier, site.data ());
+  si_split_codes (m, site.data (), code.data (), NA_REAL);
+  for (i = 0; i < m; i++)
+  {
+    out_site[si_group[i]] = site[i];
+    out_error[si_group[i]] = code[i];
+  }
+
+  return List::create (
+    Named ("plots") = DataFrame::create (
+      Named ("plot") = out_plot,
+      Named ("species") = out_species,
+      Named ("curve") = out_curve,
+      Named ("trees") = out_trees,
+      Named ("stems") = out_stems,
+      Named ("top_height") = out_height,
+      Named ("age") = out_age,
+      Named ("site_index") = out_site,
+      Named ("error") = out_error),
+    Named ("share") = share);
+}
@@ -0,0 +1,441 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * sitrace.c
+ * - call tracing: each call of index_to_height(), height_to_index(),
+ *   index_to_age() and the solvers is recorded with its curve, inputs,
+ *   result, solver steps and elapsed clock ticks, so slow curves and
+ *   inputs can be found after a batch run.
+ * - tracing is off until turned on with Sindex_TraceOn(), giving the
+ *   deepest call to record: 1 for calls from outside the package only, 2
+ *   to add the calls they make, and so on.  When off, each call costs a
+ *   test of si_trace.
+ * - each thread records into its own ring buffer of SI_TRACE_SIZE calls,
+ *   taken on its first traced call, keeping the latest.  The owning
+ *   thread writes records and then publishes them by advancing head, so
+ *   recording takes no locks.  Records are held as words stored and
+ *   loaded atomically, so they can be copied while being written.
+ * - when a thread ends, its records are moved to one ring kept for ended
+ *   threads, again keeping the latest, and its ring is put on a free
+ *   list for the next thread.  Rings in use are never more than the
+ *   threads tracing at once, plus the free ones and the ended ring.
+ * - Sindex_Trace() copies out the records of every thread.  Records that
+ *   were overwritten while being copied are left out.  Clearing marks
+ *   where each ring's records start, so threads still tracing are not
+ *   disturbed.
+ * - ticks are of the time stamp counter on x86, otherwise nanoseconds;
+ *   they are converted to nanoseconds when copied out.
+ *
+ * 2026 oct 18 - Created.
+ *             - Made si_trace atomic.
+ *             - Rings of ended threads are folded into one and reused,
+ *               not kept.  Records are copied out without data races.
+ */
+
+
+/* records per thread, a power of 2 */
+#define SI_TRACE_SIZE 65536
+
+typedef struct
+  {
+  unsigned long long ticks;
+  double        age;
+  double        height;
+  double        si;
+  double        y2bh;
+  double        result;
+  unsigned long long seq;   /* order of the call in its thread */
+  unsigned int  steps;
+  int           thread;     /* order of the thread's first traced call */
+  short int     cu_index;
+  signed char   entry;
+  signed char   depth;
+  signed char   age_type;
+  signed char   est_type;
+  } SI_TRACE_REC;
+
+/* words of a record, as stored in a ring */
+#define SI_TRACE_WORDS \
+  ((sizeof (SI_TRACE_REC) + sizeof (unsigned long long) - 1) / sizeof (unsigned long long))
+
+typedef std::atomic<unsigned long long> SI_TRACE_WORD;
+
+typedef struct
+  {
+  SI_TRACE_WORD head;       /* records written */
+  SI_TRACE_WORD tail;       /* records before it were cleared */
+  int           thread;     /* order of the first traced call */
+  SI_TRACE_WORD rec[SI_TRACE_SIZE][SI_TRACE_WORDS];
+  } SI_TRACE_RING;
+
+
+class si_trace_thread
+{
+public:
+  SI_TRACE_RING *ring;
+  unsigned long long seq;   /* calls recorded */
+  int depth;
+  si_trace_thread () : ring (NULL), seq (0), depth (0) {}
+  ~si_trace_thread ();
+};
+
+
+std::atomic<int> si_trace (0);
+
+static std::mutex si_trace_lock;
+static std::vector<SI_TRACE_RING *> si_trace_live;   /* rings of running threads */
+static std::vector<SI_TRACE_RING *> si_trace_free;   /* rings to reuse */
+static SI_TRACE_RING *si_trace_ended;                /* records of ended threads */
+static int si_trace_threads;                         /* threads that have traced */
+static thread_local si_trace_thread si_trace_own;
+
+static const char *si_trace_entry[SI_TRACE_ENTRIES] =
+  {
+  "index_to_height", "height_to_index", "index_to_age",
+  "site_iterate", "iterate", "gi_iterate", "gi_si2ht", "hu_garcia_q",
+  "total_iterate", "si_fit_plots"
+  };
+
+
+static inline unsigned long long si_trace_clock (void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc ();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds> (
+    std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+#endif
+}
+
+
+/* clock ticks per nanosecond */
+static double si_trace_rate (void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  std::chrono::steady_clock::time_point t0, t1;
+  unsigned long long c0, c1;
+
+
+  t0 = std::chrono::steady_clock::now ();
+  c0 = si_trace_clock ();
+  std::this_thread::sleep_for (std::chrono::milliseconds (5));
+  t1 = std::chrono::steady_clock::now ();
+  c1 = si_trace_clock ();
+  return (double) (c1 - c0) /
+    std::chrono::duration<double, std::nano> (t1 - t0).count ();
+#else
+  return 1.0;
+#endif
+}
+
+
+/* stores a record in a ring, at position k */
+static void si_trace_put (
+  SI_TRACE_RING *ring,
+  unsigned long long k,
+  const SI_TRACE_REC *r)
+{
+  unsigned long long w[SI_TRACE_WORDS];
+  SI_TRACE_WORD *to;
+  size_t i;
+
+
+  w[SI_TRACE_WORDS - 1] = 0;
+  memcpy (w, r, sizeof (SI_TRACE_REC));
+  to = ring->rec[k & (SI_TRACE_SIZE - 1)];
+  for (i = 0; i < SI_TRACE_WORDS; i++)
+    to[i].store (w[i], std::memory_order_relaxed);
+}
+
+
+/* loads the record at position k of a ring */
+static void si_trace_get (
+  const SI_TRACE_RING *ring,
+  unsigned long long k,
+  SI_TRACE_REC *r)
+{
+  unsigned long long w[SI_TRACE_WORDS];
+  const SI_TRACE_WORD *from;
+  size_t i;
+
+
+  from = ring->rec[k & (SI_TRACE_SIZE - 1)];
+  for (i = 0; i < SI_TRACE_WORDS; i++)
+    w[i] = from[i].load (std::memory_order_relaxed);
+  memcpy (r, w, sizeof (SI_TRACE_REC));
+}
+
+
+/* first record of a ring still held and not cleared */
+static unsigned long long si_trace_first (
+  const SI_TRACE_RING *ring,
+  unsigned long long head)
+{
+  unsigned long long first;
+
+
+  first = (head > SI_TRACE_SIZE) ? head - SI_TRACE_SIZE : 0;
+  return std::max (first, ring->tail.load (std::memory_order_relaxed));
+}
+
+
+/*
+ * a thread's records outlive it, in si_trace_ended, and its ring goes to
+ * si_trace_free for the next thread to trace
+ */
+si_trace_thread::~si_trace_thread ()
+{
+  unsigned long long head, k, to;
+  SI_TRACE_REC r;
+
+
+  if (ring == NULL)
+    return;
+
+  std::lock_guard<std::mutex> hold (si_trace_lock);
+  if (si_trace_ended == NULL)
+    si_trace_ended = new SI_TRACE_RING ();
+  head = ring->head.load (std::memory_order_relaxed);
+  to = si_trace_ended->head.load (std::memory_order_relaxed);
+  for (k = si_trace_first (ring, head); k < head; k++)
+  {
+    si_trace_get (ring, k, &r);
+    si_trace_put (si_trace_ended, to++, &r);
+  }
+  si_trace_ended->head.store (to, std::memory_order_relaxed);
+
+  si_trace_live.erase (std::find (si_trace_live.begin (), si_trace_live.end (), ring));
+  si_trace_free.push_back (ring);
+  ring = NULL;
+}
+
+
+void si_trace_begin (SI_TRACE_MARK *m)
+{
+  si_trace_own.depth++;
+  m->on = 1;
+  m->steps = si_solver_steps;
+  m->start = si_trace_clock ();
+}
+
+
+void si_trace_end (
+  SI_TRACE_MARK *m,
+  short int entry,
+  short int cu_index,
+  short int age_type,
+  short int est_type,
+  double age,
+  double height,
+  double si,
+  double y2bh,
+  double result)
+{
+  unsigned long long ticks, head;
+  SI_TRACE_RING *ring;
+  SI_TRACE_REC r;
+
+
+  ticks = si_trace_clock () - m->start;
+  if (si_trace_own.depth-- > si_trace.load (std::memory_order_relaxed))
+    return;
+
+  ring = si_trace_own.ring;
+  if (ring == NULL)
+  {
+    std::lock_guard<std::mutex> hold (si_trace_lock);
+    if (si_trace_free.empty ())
+      ring = new SI_TRACE_RING ();
+    else
+    {
+      ring = si_trace_free.back ();
+      si_trace_free.pop_back ();
+      ring->head.store (0, std::memory_order_relaxed);
+      ring->tail.store (0, std::memory_order_relaxed);
+    }
+    ring->thread = si_trace_threads++;
+    si_trace_live.push_back (ring);
+    si_trace_own.ring = ring;
+  }
+
+  r.ticks = ticks;
+  r.age = age;
+  r.height = height;
+  r.si = si;
+  r.y2bh = y2bh;
+  r.result = result;
+  r.seq = si_trace_own.seq++;
+  r.steps = (unsigned int) (si_solver_steps - m->steps);
+  r.thread = ring->thread;
+  r.cu_index = cu_index;
+  r.entry = (signed char) entry;
+  r.depth = (signed char) (si_trace_own.depth + 1);
+  r.age_type = (signed char) age_type;
+  r.est_type = (signed char) est_type;
+
+  /*
+   * head is stored before the record's words, so a reader that loads any
+   * of them then finds head past the record it overwrites
+   */
+  head = ring->head.load (std::memory_order_relaxed);
+  std::atomic_thread_fence (std::memory_order_release);
+  si_trace_put (ring, head, &r);
+  ring->head.store (head + 1, std::memory_order_release);
+}
+
+
+/*
+ * appends the records of a ring to rec, leaving out any the owner
+ * overwrote while they were copied.  With clear set, later copies start
+ * after them.
+ */
+static void si_trace_copy (
+  SI_TRACE_RING *ring,
+  bool clear,
+  std::vector<SI_TRACE_REC> &rec)
+{
+  unsigned long long head, first, done, k;
+  size_t from;
+
+
+  head = ring->head.load (std::memory_order_acquire);
+  first = si_trace_first (ring, head);
+  from = rec.size ();
+  rec.resize (from + (size_t) (head - first));
+  for (k = first; k < head; k++)
+    si_trace_get (ring, k, &rec[from + (size_t) (k - first)]);
+
+  /* drop any the owner overwrote meanwhile, or was overwriting */
+  std::atomic_thread_fence (std::memory_order_acquire);
+  done = ring->head.load (std::memory_order_relaxed) + 1;
+  if (done > first + SI_TRACE_SIZE)
+  {
+    k = std::min (done - SI_TRACE_SIZE - first, head - first);
+    rec.erase (rec.begin () + from, rec.begin () + from + (size_t) k);
+  }
+
+  if (clear)
+    ring->tail.store (head, std::memory_order_relaxed);
+}
+
+
+/*
+ * sets the deepest call to trace, 0 to stop, or leaves it (-1).  Returns
+ * the previous setting.
+ */
+// [[Rcpp::export]]
+int Sindex_TraceOn (int depth)
+{
+  int was;
+
+
+  if (depth >= 0)
+    was = si_trace.exchange (depth, std::memory_order_relaxed);
+  else
+    was = si_trace.load (std::memory_order_relaxed);
+  return was;
+}
+
+
+static bool si_trace_before (const SI_TRACE_REC &a, const SI_TRACE_REC &b)
+{
+  return a.thread < b.thread || (a.thread == b.thread && a.seq < b.seq);
+}
+
+
+/*
+ * the recorded calls of every thread, in the order they returned within
+ * each thread.  With clear set, the rings are emptied after copying.
+ */
+// [[Rcpp::export]]
+DataFrame Sindex_Trace (bool clear)
+{
+  std::vector<SI_TRACE_REC> rec;
+  const SI_CURVE *cu;
+  size_t i;
+  double rate;
+
+
+  rate = si_trace_rate ();
+  {
+    std::lock_guard<std::mutex> hold (si_trace_lock);
+    if (si_trace_ended != NULL)
+      si_trace_copy (si_trace_ended, clear, rec);
+    for (i = 0; i < si_trace_live.size (); i++)
+      si_trace_copy (si_trace_live[i], clear, rec);
+  }
+
+  /* by thread, then in the order the calls returned */
+  std::stable_sort (rec.begin (), rec.end (), si_trace_before);
+
+  IntegerVector out_thread (rec.size ());
+  NumericVector out_seq (rec.size ());
+  CharacterVector out_entry (rec.size ());
+  IntegerVector out_depth (rec.size ());
+  IntegerVector out_curve (rec.size ());
+  CharacterVector out_name (rec.size ());
+  IntegerVector out_age_type (rec.size ());
+  IntegerVector out_est_type (rec.size ());
+  NumericVector out_age (rec.size ());
+  NumericVector out_height (rec.size ());
+  NumericVector out_si (rec.size ());
+  NumericVector out_y2bh (rec.size ());
+  NumericVector out_result (rec.size ());
+  NumericVector out_steps (rec.size ());
+  NumericVector out_ticks (rec.size ());
+  NumericVector out_ns (rec.size ());
+
+  for (i = 0; i < rec.size (); i++)
+  {
+    cu = si_curve (rec[i].cu_index);
+    out_thread[i] = rec[i].thread;
+    out_seq[i] = (double) rec[i].seq;
+    out_entry[i] = si_trace_entry[rec[i].entry];
+    out_depth[i] = rec[i].depth;
+    out_curve[i] = (cu != NULL) ? rec[i].cu_index : NA_INTEGER;
+    out_name[i] = (cu != NULL) ? cu->name : "unknown";
+    out_age_type[i] = (rec[i].age_type < 0) ? NA_INTEGER : rec[i].age_type;
+    out_est_type[i] = (rec[i].est_type < 0) ? NA_INTEGER : rec[i].est_type;
+    out_age[i] = isnan (rec[i].age) ? NA_REAL : rec[i].age;
+    out_height[i] = isnan (rec[i].height) ? NA_REAL : rec[i].height;
+    out_si[i] = isnan (rec[i].si) ? NA_REAL : rec[i].si;
+    out_y2bh[i] = isnan (rec[i].y2bh) ? NA_REAL : rec[i].y2bh;
+    out_result[i] = rec[i].result;
+    out_steps[i] = rec[i].steps;
+    out_ticks[i] = (double) rec[i].ticks;
+    out_ns[i] = (double) rec[i].ticks / rate;
+  }
+
+  return DataFrame::create (
+    Named ("thread") = out_thread,
+    Named ("seq") = out_seq,
+    Named ("entry") = out_entry,
+    Named ("depth") = out_depth,
+    Named ("curve") = out_curve,
+    Named ("name") = out_name,
+    Named ("age_type") = out_age_type,
+    Named ("est_type") = out_est_type,
+    Named ("age") = out_age,
+    Named ("height") = out_height,
+    Named ("site_index") = out_si,
+    Named ("y2bh") = out_y2bh,
+    Named ("result") = out_result,
+    Named ("steps") = out_steps,
+    Named ("ticks") = out_ticks,
+    Named ("ns") = out_ns,
+    Named ("stringsAsFactors") = false);
+}
@@ -152,6 +152,10 @@ using namespace Rcpp;
  *               into steps of 0.5, 1.5, 2.5, etc.
  * 2017 feb 2  - Added Nigh's 2016 Cwc.
  * 2018 jan 11 - Added Nigh's 2017 Pli equation.
+ * 2026 oct 18 - Added si_y2bh_batch() and Sindex_Y2BHBatch(), si_y2bh()
+ *               over columns.
+ *             - Added si_y2bh_grad(), the derivative of si_y2bh() by
+ *               site index for the curves with gradient kernels.
  */
 
 
@@ -1473,3 +1477,182 @@ double si_y2bh05 (short int cu_index, double site_index)
   /* force answer to be in steps 0.5, 1.5, 2.5, etc. */
   return ((int) y2bh) + 0.5;
 }
+
+
+/*
+ * derivative of si_y2bh() by site index, for the curves with gradient
+ * kernels (sikernel.c).  NaN for other curves, and where si_y2bh() gives
+ * an error code.  0 where y2bh is held at its least value.
+ */
+double si_y2bh_grad (short int cu_index, double site_index)
+{
+  double si25;
+
+
+  if (site_index < 1.3)
+    return NAN;
+
+  switch (cu_index)
+  {
+#ifdef SI_PLI_GOUDIE_DRY
+  case SI_PLI_GOUDIE_DRY:
+#endif
+#ifdef SI_PLI_GOUDIE_WET
+  case SI_PLI_GOUDIE_WET:
+#endif
+#ifdef SI_PLI_DEMPSTER
+  case SI_PLI_DEMPSTER:
+#endif
+#ifdef SI_PLI_CIESZEWSKI
+  case SI_PLI_CIESZEWSKI:
+#endif
+    return -42.64 / (site_index * site_index);
+
+#ifdef SI_SW_GOUDIE_PLA
+  case SI_SW_GOUDIE_PLA:
+#endif
+#ifdef SI_SW_GOUDIE_NAT
+  case SI_SW_GOUDIE_NAT:
+#endif
+#ifdef SI_SW_DEMPSTER
+  case SI_SW_DEMPSTER:
+#endif
+#ifdef SI_SW_CIESZEWSKI
+  case SI_SW_CIESZEWSKI:
+#endif
+#ifdef SI_SE_NIGH
+  case SI_SE_NIGH:
+#endif
+    return -110.76 / (site_index * site_index);
+
+#ifdef SI_SB_DEMPSTER
+  case SI_SB_DEMPSTER:
+#endif
+#ifdef SI_SB_CIESZEWSKI
+  case SI_SB_CIESZEWSKI:
+#endif
+#ifdef SI_SB_NIGH
+  case SI_SB_NIGH:
+#endif
+    return -61.08 / (site_index * site_index);
+
+#ifdef SI_AT_GOUDIE
+  case SI_AT_GOUDIE:
+#endif
+#ifdef SI_AT_CIESZEWSKI
+  case SI_AT_CIESZEWSKI:
+#endif
+#ifdef SI_AT_NIGH
+  case SI_AT_NIGH:
+#endif
+#ifdef SI_EP_NIGH
+  case SI_EP_NIGH:
+#endif
+    return -38.56 / (site_index * site_index);
+
+#ifdef SI_FDI_THROWER
+  case SI_FDI_THROWER:
+    return -99.0 / (site_index * site_index);
+#endif
+
+#ifdef SI_LW_NIGH
+  case SI_LW_NIGH:
+    return -87.18 / (site_index * site_index);
+#endif
+
+#ifdef SI_SS_GOUDIE
+  case SI_SS_GOUDIE:
+#endif
+#ifdef SI_SS_NIGH
+  case SI_SS_NIGH:
+#endif
+    if (11.7 - site_index / 5.4054 < 1)
+      return 0;
+    return -1 / 5.4054;
+
+#ifdef SI_CWI_NIGH
+  case SI_CWI_NIGH:
+    if (18.18 - 0.5526 * site_index < 1)
+      return 0;
+    return -0.5526;
+#endif
+
+#ifdef SI_CWC_NIGH
+  case SI_CWC_NIGH:
+    if (13.25 - site_index / 6.096 < 1)
+      return 0;
+    return -1 / 6.096;
+#endif
+
+#ifdef SI_BA_NIGH
+  case SI_BA_NIGH:
+    if (18.47373 - 0.4086 * site_index < 5.0)
+      return 0;
+    return -0.4086;
+#endif
+
+#ifdef SI_HWI_NIGH
+  case SI_HWI_NIGH:
+    if (446.6 * PPOW (site_index, -1.432) < 1)
+      return 0;
+    return 446.6 * -1.432 * PPOW (site_index, -2.432);
+#endif
+
+#ifdef SI_PY_NIGH
+  case SI_PY_NIGH:
+    return 36.35 * pow (0.9318, site_index) * log (0.9318);
+#endif
+
+#ifdef SI_DR_NIGH
+  case SI_DR_NIGH:
+    si25 = 0.3094 + 0.7616 * site_index;
+    if (si25 <= 25)
+      return -0.1789 * 0.7616;
+    return 0;
+#endif
+  }
+
+  return NAN;
+}
+
+
+/*
+ * si_y2bh(), or si_y2bh05() if half is set, for n rows.
+ */
+void si_y2bh_batch (
+  int n,
+  const int *cu_index,
+  const double *site_index,
+  int half,
+  double *y2bh)
+{
+  int i;
+
+
+  for (i = 0; i < n; i++)
+  {
+    y2bh[i] = si_y2bh ((short int) cu_index[i], site_index[i]);
+    if (half)
+      y2bh[i] = ((int) y2bh[i]) + 0.5;
+  }
+}
+
+
+// [[Rcpp::export]]
+NumericVector Sindex_Y2BHBatch (
+    IntegerVector cu_index,
+    NumericVector site_index,
+    bool half = false)
+{
+  int n = cu_index.size ();
+
+
+  if (site_index.size () != n)
+    stop ("all inputs must have the same length");
+
+  NumericVector y2bh (n);
+  si_y2bh_batch (n, cu_index.begin (), site_index.begin (), half ? 1 : 0,
+    y2bh.begin ());
+
+  return y2bh;
+}
@@ -0,0 +1,319 @@
+#include <Rcpp.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "sindex.h"
+using namespace Rcpp;
+
+/*
+ * siyield.c
+ * - yield tables: height of each unit, given its curve, site index and
+ *   years to breast height, at each of a list of ages, with the unit's
+ *   total and breast height ages.
+ * - units are grouped by curve, and each group is cut into blocks of
+ *   SI_YIELD_BLOCK units.  A block's cells are handed to the curve's
+ *   batch kernel in one call, so the kernel and its coefficients stay in
+ *   cache while the block's rows are computed.  A unit's ages are
+ *   consecutive rows, so kernels work out the terms of its site index
+ *   once for all of them.  Curves without kernels of their own still
+ *   take index_to_height() for each cell; of the species defaults, that
+ *   is only Bruce's Fdc AC, whose y2bh comes from its site index.
+ * - blocks are shared among threads, each taking the next block not yet
+ *   taken.  Threads call only the curves' functions, never R.
+ * - blocks write their heights in grouped order, so each block's column
+ *   is contiguous.  A last pass puts them back in the units' order and
+ *   adds the ages, writing the results in the order R stores them.
+ * - heights and error codes are those of index_to_height(), and ages
+ *   are as age_to_age() converts them with the unit's y2bh.
+ * - each unit may start at an age of its own, the table's ages then
+ *   being years from it, so stands can be projected from their ages.
+ *
+ * 2026 oct 18 - Created.
+ *             - Added an age for each unit to start from.
+ *             - Rows by unit then age, rather than age then unit.
+ *             - Every species default but Bruce's Fdc AC now has a kernel.
+ */
+
+
+/* units in a block, so a block's rows fit in the level 2 cache */
+#define SI_YIELD_BLOCK 64
+
+/* one block of units of one curve */
+typedef struct
+  {
+  short int cu_index;   /* SI_MAX_CURVES for unknown curves */
+  int       first;      /* in the grouped order */
+  int       units;
+  } SI_YIELD_WORK;
+
+/* a table being made, shared by its threads */
+typedef struct
+  {
+  int           n;
+  const int    *cu_index;
+  const double *site_index;
+  const double *y2bh;
+  int           m;
+  const double *age;
+  const double *unit_age;   /* age of each unit, or NULL */
+  int           age_type;
+  double        pi;
+  int           tier;
+  double       *grouped;    /* heights, n by m, in grouped order */
+  const int    *perm;
+  std::vector<SI_YIELD_WORK> work;
+  std::atomic<size_t> next;   /* block to take */
+  } SI_YIELD_JOB;
+
+
+/* a thread's rows for one block */
+typedef struct
+  {
+  std::vector<double> age;
+  std::vector<int>    type;
+  std::vector<double> si;
+  std::vector<double> y2bh;
+  std::vector<double> ht;
+  } SI_YIELD_ROWS;
+
+
+static void si_yield_block (
+  SI_YIELD_JOB *job,
+  const SI_YIELD_WORK *w,
+  SI_YIELD_ROWS *r)
+{
+  int j, k, u, rows, row;
+  const SI_CURVE *cu;
+
+
+  rows = w->units * job->m;
+  r->age.resize (rows);
+  r->type.resize (rows);
+  r->si.resize (rows);
+  r->y2bh.resize (rows);
+  r->ht.resize (rows);
+
+  /* rows by unit then age, so a unit's site index repeats */
+  for (k = 0; k < w->units; k++)
+    for (j = 0; j < job->m; j++)
+    {
+      u = job->perm[w->first + k];
+      row = k * job->m + j;
+      r->age[row] = job->age[j] +
+        ((job->unit_age != NULL) ? job->unit_age[u] : 0);
+      r->type[row] = job->age_type;
+      r->si[row] = job->site_index[u];
+      r->y2bh[row] = job->y2bh[u];
+    }
+
+  cu = si_curve (w->cu_index);
+  if (cu != NULL)
+    cu->height_tier[job->tier] (w->cu_index, rows, r->age.data (),
+      r->type.data (), r->si.data (), r->y2bh.data (), job->pi,
+      r->ht.data ());
+
+  for (k = 0; k < w->units; k++)
+    for (j = 0; j < job->m; j++)
+    {
+      row = k * job->m + j;
+
+      /* unknown curves, error codes as from index_to_height() */
+      if (cu == NULL)
+      {
+        u = job->perm[w->first + k];
+        r->ht[row] = index_to_height ((short int) job->cu_index[u],
+          r->age[row], (short int) job->age_type, r->si[row], r->y2bh[row],
+          job->pi);
+      }
+
+      job->grouped[(size_t) j * job->n + w->first + k] = r->ht[row];
+    }
+}
+
+
+static void si_yield_worker (SI_YIELD_JOB *job)
+{
+  SI_YIELD_ROWS rows;
+  size_t b;
+
+
+  while ((b = job->next.fetch_add (1)) < job->work.size ())
+    si_yield_block (job, &job->work[b], &rows);
+}
+
+
+/*
+ * yield tables for n units at m ages of one type.  With unit_age, the
+ * ages are added to each unit's own age.  Results are n by m, by column.
+ * threads of 0 or less uses every core.
+ */
+void si_yield_table (
+  int n,
+  const int *cu_index,
+  const double *site_index,
+  const double *y2bh,
+  int m,
+  const double *age,
+  const double *unit_age,
+  int age_type,
+  double pi,
+  int tier,
+  int threads,
+  double *height,
+  double *total_age,
+  double *breast_age)
+{
+  std::vector<int> start (SI_MAX_CURVES + 2);
+  std::vector<int> perm (n);
+  std::vector<int> place (n);
+  std::vector<double> grouped ((size_t) n * m);
+  std::vector<std::thread> pool;
+  SI_YIELD_JOB job;
+  SI_YIELD_WORK w;
+  size_t cell;
+  double a;
+  int g, t, i, j;
+  short int cu, from, to;
+
+
+  si_group_rows (n, cu_index, start.data (), perm.data ());
+
+  job.n = n;
+  job.cu_index = cu_index;
+  job.site_index = site_index;
+  job.y2bh = y2bh;
+  job.m = m;
+  job.age = age;
+  job.unit_age = unit_age;
+  job.age_type = age_type;
+  job.pi = pi;
+  job.tier = tier;
+  job.grouped = grouped.data ();
+  job.perm = perm.data ();
+  job.next = 0;
+
+  for (g = 0; g <= SI_MAX_CURVES; g++)
+    for (w.first = start[g]; w.first < start[g + 1]; w.first += SI_YIELD_BLOCK)
+    {
+      w.cu_index = (short int) g;
+      w.units = std::min (SI_YIELD_BLOCK, start[g + 1] - w.first);
+      job.work.push_back (w);
+    }
+
+  if (threads <= 0)
+    threads = (int) std::thread::hardware_concurrency ();
+  threads = std::max (1, std::min (threads, (int) job.work.size ()));
+
+  for (t = 1; t < threads; t++)
+    pool.push_back (std::thread (si_yield_worker, &job));
+  si_yield_worker (&job);
+  for (t = 0; t < (int) pool.size (); t++)
+    pool[t].join ();
+
+  /* back in the units' order, with the ages */
+  for (i = 0; i < n; i++)
+    place[perm[i]] = i;
+  from = (short int) age_type;
+  to = (short int) (SI_AT_TOTAL + SI_AT_BREAST - age_type);
+  for (j = 0; j < m; j++)
+    for (i = 0; i < n; i++)
+    {
+      cell = (size_t) j * n + i;
+      cu = (short int) cu_index[i];
+      a = age[j] + ((unit_age != NULL) ? unit_age[i] : 0);
+      height[cell] = grouped[(size_t) j * n + place[i]];
+      if (age_type == SI_AT_TOTAL)
+      {
+        total_age[cell] = a;
+        breast_age[cell] = si_age_to_age (cu, a, from, to, y2bh[i]);
+      }
+      else
+      {
+        breast_age[cell] = a;
+        total_age[cell] = si_age_to_age (cu, a, from, to, y2bh[i]);
+      }
+    }
+}
+
+
+/*
+ * yield tables as matrices of a row per unit and a column per age, or
+ * with long_table set, as a data frame of a row per unit and age.
+ * Heights that are error codes are NA, with the code in error.
+ */
+// [[Rcpp::export]]
+List Sindex_YieldTable (
+    IntegerVector cu_index,
+    NumericVector site_index,
+    NumericVector y2bh,
+    NumericVector age,
+    int age_type,
+    double pi,
+    int tier = 0,
+    int threads = 0,
+    bool long_table = false)
+{
+  int n = cu_index.size ();
+  int m = age.size ();
+  size_t cells, c;
+  int i, j;
+
+
+  if (site_index.size () != n || y2bh.size () != n)
+    stop ("all inputs must have the same length");
+  if (age_type != SI_AT_TOTAL && age_type != SI_AT_BREAST)
+    stop ("unknown age type");
+  if (tier < 0 || tier >= SI_MATH_TIERS)
+    stop ("unknown math tier");
+
+  cells = (size_t) n * m;
+  NumericMatrix height (n, m);
+  NumericMatrix total_age (n, m);
+  NumericMatrix breast_age (n, m);
+  si_yield_table (n, cu_index.begin (), site_index.begin (), y2bh.begin (),
+    m, age.begin (), NULL, age_type, pi, tier, threads, height.begin (),
+    total_age.begin (), breast_age.begin ());
+
+  std::vector<signed char> code (cells);
+  si_split_codes ((int) cells, height.begin (), code.data (), NA_REAL);
+
+  if (!long_table)
+  {
+    IntegerMatrix error (n, m);
+    for (c = 0; c < cells; c++)
+      error[c] = code[c];
+    return List::create (
+      Named ("height") = height,
+      Named ("error") = error,
+      Named ("total_age") = total_age,
+      Named ("breast_age") = breast_age);
+  }
+
+  /* by unit, then age */
+  IntegerVector out_unit (cells);
+  NumericVector out_total (cells);
+  NumericVector out_breast (cells);
+  NumericVector out_height (cells);
+  IntegerVector out_error (cells);
+  c = 0;
+  for (i = 0; i < n; i++)
+    for (j = 0; j < m; j++)
+    {
+      out_unit[c] = i + 1;
+      out_total[c] = total_age[(size_t) j * n + i];
+      out_breast[c] = breast_age[(size_t) j * n + i];
+      out_height[c] = height[(size_t) j * n + i];
+      out_error[c] = code[(size_t) j * n + i];
+      c++;
+    }
+
+  return DataFrame::create (
+    Named ("unit") = out_unit,
+    Named ("total_age") = out_total,
+    Named ("breast_age") = out_breast,
+    Named ("height") = out_height,
+    Named ("error") = out_error);
+}
@@ -58,6 +58,8 @@ using namespace Rcpp;
  * 2009 aug 18 - Changed E* remaps from At to Ep.
  * 2015 apr 9  - Removed species code "Bv".
  * 2018 jan 18 - Added species codes Ey, Js, Ld, Ls, Oh, Oi, Oj, Ok, Qw.
+ * 2026 oct 18 - Copy loops no longer read past the end of the incoming
+ *               string, or write past the end of sc2[].
  */
 
 
@@ -73,7 +75,7 @@ short int species_map (std::string sc)
   for (i = 0; i < strlen (sc) && i < 10; i++)
   the below is modified line*/
 
-  for (i = 0; i < 10; i++)
+  for (i = 0; i < (short int) sc.length () && i2 < 9; i++)
   {
     if (sc[i] != ' ')
     {
@@ -245,7 +247,7 @@ short int species_remap (std::string sc, char fiz)
    * for (i = 0; i < strlen (sc) && i < 10; i++)
    * new line below
    */
-  for (i = 0; i < 10; i++)
+  for (i = 0; i < (short int) sc.length () && i2 < 9; i++)
   {
     if (sc[i] != ' ')
     {